@@ -31,6 +31,11 @@ void SonyGamepadAbstract::EnableMotionSensor(bool bIsMotionSensor)
 	HIDDeviceContexts.bEnableAccelerometerAndGyroscope = bIsMotionSensor;
 }
 
+void SonyGamepadAbstract::EnableInputDrain(bool bDrain)
+{
+	HIDDeviceContexts.bDrainInputReports = bDrain;
+}
+
 float SonyGamepadAbstract::GetBattery()
 {
 	return HIDDeviceContexts.GetInputState()->BatteryLevel;
@@ -9,12 +9,13 @@
 #include "GCore/Types/Structs/Context/DeviceContext.h"
 #include "GCore/Utils/CR32.h"
 #include "GCore/Utils/SoDefines.h"
+#include "GImplementations/Utils/GamepadAudioEngine.h"
 #include "GImplementations/Utils/GamepadInput.h"
 #include "GImplementations/Utils/GamepadOutput.h"
 #include "GImplementations/Utils/GamepadSensors.h"
 #include "GImplementations/Utils/GamepadTouch.h"
 #include "GImplementations/Utils/GamepadTrigger.h"
-#include <thread>
+#include <algorithm>
 
 using namespace FDualSenseTriggerComposer;
 
@@ -74,72 +75,126 @@ void FDualSenseLibrary::SetLightbar(DSCoreTypes::FDSColor Color)
 
 bool FDualSenseLibrary::Initialize(const FDeviceContext& Context)
 {
-	SetDeviceContexts(Context);
+	return InitializeWith(IPlatformHardwareInfo::Get(), Context);
+}
+
+void FDualSenseLibrary::ComposeEnableReport(FDeviceContext* DSContext)
+{
+	unsigned char* MutableBuffer = DSContext->GetRawOutputBuffer();
+	size_t Padding = 2;
+	MutableBuffer[0] = 0x31;
+	MutableBuffer[1] = 0x02;
+
+	unsigned char* Output = &MutableBuffer[Padding];
+	Output[0] = 0xFF;
+	Output[1] = 0b11111111;
+	Output[38] = 0x00;
+	Output[44] = 0x00;
+	Output[45] = 0x00;
+	Output[46] = 0x00;
+
+	const auto CrcChecksum = GCoreUtils::CR32::Compute(MutableBuffer, 74);
+	MutableBuffer[0x4A] = static_cast<unsigned char>((CrcChecksum & 0x000000FF) >> 0UL);
+	MutableBuffer[0x4B] = static_cast<unsigned char>((CrcChecksum & 0x0000FF00) >> 8UL);
+	MutableBuffer[0x4C] = static_cast<unsigned char>((CrcChecksum & 0x00FF0000) >> 16UL);
+	MutableBuffer[0x4D] = static_cast<unsigned char>((CrcChecksum & 0xFF000000) >> 24UL);
+
+	// The controller needs ~50 ms to apply the enable report. Instead of
+	// sleeping here, the remaining setup runs from AdvanceInitialization.
+	EnableReportDeadlineUs = gc_time::now_us() + EnableReportDelayUs;
+	InitializationState = EDSInitializationState::WaitingEnableReport;
+}
+
+void FDualSenseLibrary::FinishUsbInitialization()
+{
 	FDeviceContext* DSContext = GetMutableDeviceContext();
-	if (DSContext->ConnectionType == EDSDeviceConnection::Bluetooth)
+	ResetLights();
+	constexpr std::uint8_t FeatureMode = 0x57;
+	DSContext->Output.Feature = {FeatureMode, 0xFF, 0x00, 0x00};
+	InitializationState.store(EDSInitializationState::Ready, std::memory_order_release);
+	UpdateOutput();
+}
+
+bool FDualSenseLibrary::AdvanceInitialization()
+{
+	const EDSInitializationState State = InitializationState.load(std::memory_order_acquire);
+	if (State != EDSInitializationState::WaitingEnableReport)
+	{
+		return State == EDSInitializationState::Ready;
+	}
+
 	{
+		FDeviceContext* DSContext = GetMutableDeviceContext();
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(DSContext->OutputMutex);
+		if (InitializationState.load(std::memory_order_acquire) != EDSInitializationState::WaitingEnableReport)
 		{
-			gc_lock::lock_guard<gc_lock::mutex> LockGuard(DSContext->OutputMutex);
-			unsigned char* MutableBuffer = DSContext->GetRawOutputBuffer();
-			size_t Padding = 2;
-			MutableBuffer[0] = 0x31;
-			MutableBuffer[1] = 0x02;
-
-			unsigned char* Output = &MutableBuffer[Padding];
-			Output[0] = 0xFF;
-			Output[1] = 0b11111111;
-			Output[38] = 0x00;
-			Output[44] = 0x00;
-			Output[45] = 0x00;
-			Output[46] = 0x00;
-			if (DSContext->ConnectionType == EDSDeviceConnection::Bluetooth)
-			{
-				const auto CrcChecksum = GCoreUtils::CR32::Compute(MutableBuffer, 74);
-				MutableBuffer[0x4A] = static_cast<unsigned char>((CrcChecksum & 0x000000FF) >> 0UL);
-				MutableBuffer[0x4B] = static_cast<unsigned char>((CrcChecksum & 0x0000FF00) >> 8UL);
-				MutableBuffer[0x4C] = static_cast<unsigned char>((CrcChecksum & 0x00FF0000) >> 16UL);
-				MutableBuffer[0x4D] = static_cast<unsigned char>((CrcChecksum & 0xFF000000) >> 24UL);
-			}
-
-			IPlatformHardwareInfo::Get().Write(DSContext);
-			gc_sync::sleep_ms(50);
+			return IsReady();
+		}
+		if (!AdvanceInitializationLocked())
+		{
+			return false;
 		}
-		DSContext->Output.Feature.VibrationMode = 0xFF;
-		DSContext->Output.Feature.FeatureMode = 0x57;
-
-		// Audio haptics bluetooth
-		DSContext->BufferAudio[0] = 0x32;
-		DSContext->BufferAudio[1] = 0x00;
-		DSContext->BufferAudio[2] = 0x91;
-		DSContext->BufferAudio[3] = 0x07;
-		DSContext->BufferAudio[4] = 0xFE;
-		DSContext->BufferAudio[5] = 55;
-		DSContext->BufferAudio[6] = 55;
-		DSContext->BufferAudio[7] = 55;
-		DSContext->BufferAudio[8] = 55;
-		DSContext->BufferAudio[9] = 0xFF;
-
-		ResetLights();
-		UpdateOutput();
-		return true;
 	}
 
-	ResetLights();
-	constexpr std::uint8_t FeatureMode = 0x57;
-	DSContext->Output.Feature = {FeatureMode, 0xFF, 0x00, 0x00};
+	// This call finished the setup: send the lightbar, player LEDs and
+	// feature bytes right away, as the blocking initialization did.
 	UpdateOutput();
 	return true;
 }
 
-void FDualSenseLibrary::UpdateInput(float /*Delta*/)
+bool FDualSenseLibrary::AdvanceInitializationLocked()
 {
-	FDeviceContext* Context = GetMutableDeviceContext();
-	if (!Context || !Context->IsConnected)
+	const EDSInitializationState State = InitializationState.load(std::memory_order_acquire);
+	if (State != EDSInitializationState::WaitingEnableReport)
 	{
-		return;
+		return State == EDSInitializationState::Ready;
+	}
+
+	if (gc_time::now_us() < EnableReportDeadlineUs)
+	{
+		return false;
 	}
 
-	IPlatformHardwareInfo::Get().Read(Context);
+	// The setup is written under the OutputMutex and published last, so a
+	// thread that sees Ready also sees the finished feature and headers.
+	FinishBluetoothInitialization();
+	InitializationState.store(EDSInitializationState::Ready, std::memory_order_release);
+	return true;
+}
+
+bool FDualSenseLibrary::IsReady() const
+{
+	return InitializationState.load(std::memory_order_acquire) == EDSInitializationState::Ready;
+}
+
+void FDualSenseLibrary::FinishBluetoothInitialization()
+{
+	FDeviceContext* DSContext = GetMutableDeviceContext();
+	DSContext->Output.Feature.VibrationMode = 0xFF;
+	DSContext->Output.Feature.FeatureMode = 0x57;
+
+	// Audio haptics bluetooth
+	DSContext->BufferAudio[0] = 0x32;
+	DSContext->BufferAudio[1] = 0x00;
+	DSContext->BufferAudio[2] = 0x91;
+	DSContext->BufferAudio[3] = 0x07;
+	DSContext->BufferAudio[4] = 0xFE;
+	DSContext->BufferAudio[5] = 55;
+	DSContext->BufferAudio[6] = 55;
+	DSContext->BufferAudio[7] = 55;
+	DSContext->BufferAudio[8] = 55;
+	DSContext->BufferAudio[9] = 0xFF;
+
+	ResetLights();
+}
+
+void FDualSenseLibrary::UpdateInput(float /*Delta*/)
+{
+	ReadInput(IPlatformHardwareInfo::Get());
+}
+
+void FDualSenseLibrary::DecodeInput(FDeviceContext* Context)
+{
 	FInputContext* InputToFill = Context->GetBackBuffer();
 	const size_t Padding =
 	    Context->ConnectionType == EDSDeviceConnection::Bluetooth ? 2 : 1;
@@ -153,27 +208,51 @@ void FDualSenseLibrary::UpdateInput(float /*Delta*/)
 		ProcessTouchDualSense(&Context->Buffer[Padding], InputToFill);
 	}
 
+	DSCoreTypes::DSVector3D GyroDeg;
+	DSCoreTypes::DSVector3D AccelG;
+	const bool bDrainedMotion = DrainedMotion.Resolve(GyroDeg, AccelG);
 	if (Context->bEnableAccelerometerAndGyroscope)
 	{
-		DSCoreTypes::DSVector3D GyroDeg;
-		DSCoreTypes::DSVector3D AccelG;
-
-		using namespace FGamepadSensors;
-		ProcessMotionDualSense(&Context->Buffer[Padding], Context->Calibration, GyroDeg, AccelG);
+		if (!bDrainedMotion)
+		{
+			using namespace FGamepadSensors;
+			ProcessMotionDualSense(&Context->Buffer[Padding], Context->Calibration, GyroDeg, AccelG);
+		}
 
 		InputToFill->Gyroscope = GyroDeg;
 		InputToFill->Accelerometer = AccelG;
 	}
 
-	static bool bLastMuteState = false;
-	if (InputToFill->bMute && !bLastMuteState)
+	UpdateMuteState(Context, InputToFill->bMute);
+	Context->SwapInputBuffers();
+}
+
+void FDualSenseLibrary::OnInputReport(FDeviceContext* Context)
+{
+	const size_t Padding =
+	    Context->ConnectionType == EDSDeviceConnection::Bluetooth ? 2 : 1;
+	const unsigned char* Report = &Context->Buffer[Padding];
+
+	if (Context->bEnableAccelerometerAndGyroscope)
+	{
+		DSCoreTypes::DSVector3D GyroDeg;
+		DSCoreTypes::DSVector3D AccelG;
+		FGamepadSensors::ProcessMotionDualSense(Report, Context->Calibration, GyroDeg, AccelG);
+		DrainedMotion.Add(GyroDeg, AccelG);
+	}
+
+	// A press shorter than the consumer's update interval still toggles.
+	UpdateMuteState(Context, (Report[0x09] & DSCoreTypes::InputMasks::Menu::Mute) != 0);
+}
+
+void FDualSenseLibrary::UpdateMuteState(FDeviceContext* Context, bool bMute)
+{
+	if (bMute && !bLastMuteState)
 	{
 		Context->Output.Audio.MicStatus = (Context->Output.Audio.MicStatus == 0) ? 1 : 0;
 		UpdateOutput();
 	}
-	bLastMuteState = InputToFill->bMute;
-
-	Context->SwapInputBuffers();
+	bLastMuteState = bMute;
 }
 
 void FDualSenseLibrary::DualSenseSettings(std::uint8_t bIsMic, std::uint8_t bIsHeadset, std::uint8_t bIsSpeaker, std::uint8_t MicVolume, std::uint8_t AudioVolume, std::uint8_t RumbleMode, std::uint8_t RumbleReduce, std::uint8_t TriggerReduce)
@@ -199,12 +278,45 @@ void FDualSenseLibrary::DualSenseSettings(std::uint8_t bIsMic, std::uint8_t bIsH
 
 void FDualSenseLibrary::UpdateOutput()
 {
-	FDeviceContext* Context = GetMutableDeviceContext();
+	WriteOutput(IPlatformHardwareInfo::Get());
+}
+
+bool FDualSenseLibrary::BeginOutputUpdate(FDeviceContext* Context)
+{
 	if (!Context || !Context->IsConnected)
 	{
-		return;
+		return false;
+	}
+
+	if (!AdvanceInitializationLocked())
+	{
+		return false;
+	}
+
+	// The link scheduler writes the report itself, between haptic packets.
+	if (LinkScheduler.IsRunning())
+	{
+		LinkScheduler.RequestOutputReport();
+		return false;
+	}
+	return true;
+}
+
+bool FDualSenseLibrary::ComposeOutputReport(FDeviceContext* Context)
+{
+	TriggerSequencer.Tick(Context->Output, gc_time::now_us());
+	return FGamepadOutput::ComposeDualSense(Context);
+}
+
+bool FDualSenseLibrary::PrepareOutput()
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!BeginOutputUpdate(Context))
+	{
+		return false;
 	}
-	FGamepadOutput::OutputDualSense(Context);
+
+	return ComposeOutputReport(Context);
 }
 
 void FDualSenseLibrary::SetResistance(std::uint8_t StartZones,
@@ -212,6 +324,7 @@ void FDualSenseLibrary::SetResistance(std::uint8_t StartZones,
                                       const EDSGamepadHand& Hand)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	Resistance(Context, StartZones, Strength, Hand);
 }
 
@@ -223,6 +336,7 @@ void FDualSenseLibrary::SetGalloping23(std::uint8_t StartPosition,
                                        const EDSGamepadHand& Hand)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	Galloping23(Context, StartPosition, EndPosition, FirstFoot, SecondFoot,
 	            Frequency, Hand);
 }
@@ -230,12 +344,14 @@ void FDualSenseLibrary::SetGalloping23(std::uint8_t StartPosition,
 void FDualSenseLibrary::StopTrigger(const EDSGamepadHand& Hand)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	Off(Context, Hand);
 }
 
 void FDualSenseLibrary::SetGameCube(const EDSGamepadHand& Hand)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	GameCube(Context, Hand);
 }
 
@@ -244,6 +360,7 @@ void FDualSenseLibrary::SetBow22(std::uint8_t StartZone, std::uint8_t SnapBack,
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
 	Context->bOverrideTriggerBytes = false;
+	StopTriggerSequence(Hand);
 	Bow22(Context, StartZone, SnapBack, Hand);
 }
 
@@ -253,6 +370,7 @@ void FDualSenseLibrary::SetWeapon25(std::uint8_t StartZone,
                                     const EDSGamepadHand& Hand)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	Weapon25(Context, StartZone, Amplitude, Behavior, Trigger, Hand);
 }
 
@@ -263,6 +381,7 @@ void FDualSenseLibrary::SetMachineGun26(std::uint8_t StartZone,
                                         const EDSGamepadHand& Hand)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	MachineGun26(Context, StartZone, Behavior, Amplitude, Frequency, Hand);
 }
 
@@ -274,17 +393,56 @@ void FDualSenseLibrary::SetMachine27(std::uint8_t StartZone,
                                      const EDSGamepadHand& Hand)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	Machine27(Context, StartZone, BehaviorFlag, Force, Amplitude, Period,
 	          Frequency, Hand);
 }
 
 void FDualSenseLibrary::SetCustomTrigger(
     const EDSGamepadHand& Hand, const std::vector<std::uint8_t>& HexBytes)
+{
+	if (HexBytes.size() < 10)
+	{
+		return;
+	}
+
+	SetCustomTrigger(Hand, std::span<const std::uint8_t, 10>(HexBytes.data(), 10));
+}
+
+void FDualSenseLibrary::SetCustomTrigger(
+    const EDSGamepadHand& Hand, std::span<const std::uint8_t, 10> HexBytes)
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
+	StopTriggerSequence(Hand);
 	CustomTrigger(Context, Hand, HexBytes);
 }
 
+void FDualSenseLibrary::PlayTriggerSequence(const EDSGamepadHand& Hand,
+                                            const std::vector<FGamepadTriggerKeyframe>& Keyframes,
+                                            bool bLoop)
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	Context->bOverrideTriggerBytes = false;
+
+	// The output path evaluates the sequences under the same lock.
+	gc_lock::lock_guard<gc_lock::mutex> LockGuard(Context->OutputMutex);
+	TriggerSequencer.Play(Hand, Keyframes, bLoop, gc_time::now_us());
+}
+
+void FDualSenseLibrary::StopTriggerSequence(const EDSGamepadHand& Hand)
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	gc_lock::lock_guard<gc_lock::mutex> LockGuard(Context->OutputMutex);
+	TriggerSequencer.Stop(Hand);
+}
+
+bool FDualSenseLibrary::IsTriggerSequencePlaying(const EDSGamepadHand& Hand)
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	gc_lock::lock_guard<gc_lock::mutex> LockGuard(Context->OutputMutex);
+	return TriggerSequencer.IsPlaying(Hand);
+}
+
 void FDualSenseLibrary::SetPlayerLed(EDSPlayer Led, std::uint8_t Brightness)
 {
 	FOutputContext* HidOutput = &GetMutableDeviceContext()->Output;
@@ -302,28 +460,411 @@ void FDualSenseLibrary::SetMicrophoneLed(EDSMic /*Led*/)
 
 void FDualSenseLibrary::AudioHapticUpdate(const std::vector<std::uint8_t>& Data)
 {
-	FDeviceContext* Context = GetMutableDeviceContext();
-	if (!Context || !Context->IsConnected)
+	if (Data.size() < 64)
 	{
 		return;
 	}
 
+	AudioHapticUpdate(std::span<const std::uint8_t, 64>(Data.data(), 64));
+}
+
+void FDualSenseLibrary::AudioHapticUpdate(std::span<const std::uint8_t, 64> Data)
+{
+	// The audio report header is only written once the controller is ready.
+	if (!IsReady())
+	{
+		return;
+	}
+
+	if (LinkScheduler.IsRunning())
+	{
+		LinkScheduler.QueueHapticPacket(Data);
+		return;
+	}
+
+	SendHapticPacket(Data);
+}
+
+void FDualSenseLibrary::SendHapticPacket(std::span<const std::uint8_t, 64> Data)
+{
+	WriteHapticPacket(IPlatformHardwareInfo::Get(), Data);
+}
+
+void FDualSenseLibrary::ComposeHapticPacket(FDeviceContext* Context, std::span<const std::uint8_t, 64> Data)
+{
 	unsigned char* AudioData = &Context->BufferAudio[10];
 	AudioData[0] = (AudioVibrationSequence++) & 0xFF;
 	AudioData[1] = 0x92;
 	AudioData[2] = 0x40;
 	std::memcpy(&AudioData[3], Data.data(), 64);
-	FGamepadOutput::SendAudioHapticAdvanced(Context);
 }
 
 void FDualSenseLibrary::AudioHapticUpdate(const std::vector<std::int16_t>& AudioData)
 {
+	AudioHapticUpdate(std::span<const std::int16_t>(AudioData));
+}
+
+void FDualSenseLibrary::SetHapticsSampleRate(std::uint32_t SampleRate)
+{
+	RequestedHapticsSampleRate.store(std::max<std::uint32_t>(SampleRate, 1), std::memory_order_relaxed);
+	bHapticsSettingsPending.store(true, std::memory_order_release);
+}
+
+void FDualSenseLibrary::SetHapticsDsp(const FHapticsDspConfig& Config)
+{
+	{
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(HapticsSettingsMutex);
+		RequestedHapticsDsp = Config;
+	}
+	bHapticsSettingsPending.store(true, std::memory_order_release);
+}
+
+void FDualSenseLibrary::ApplyHapticsSettings()
+{
+	if (!bHapticsSettingsPending.exchange(false, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+	FHapticsDspConfig Config;
+	{
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(HapticsSettingsMutex);
+		Config = RequestedHapticsDsp;
+	}
+
+	const std::uint32_t SampleRate = RequestedHapticsSampleRate.load(std::memory_order_relaxed);
+	if (SampleRate != HapticsEncoder.GetInputSampleRate())
+	{
+		HapticsEncoder.SetInputSampleRate(SampleRate);
+		HapticsMixer.SetSampleRate(SampleRate);
+	}
+	HapticsDsp.Configure(Config, SampleRate);
+}
+
+void FDualSenseLibrary::RenderHapticsMixer(std::uint32_t Frames)
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!Context || !Context->IsConnected)
+	{
+		return;
+	}
+
+	ApplyHapticsSettings();
+
+#if GAMEPAD_CORE_HAS_AUDIO
+	if (Frames == 0 && Context->ConnectionType != EDSDeviceConnection::Bluetooth && Context->AudioContext && Context->AudioContext->IsValid())
+	{
+		const FHapticsBufferStats Stats = Context->AudioContext->GetStats();
+		Frames = Stats.FillFrames < Stats.TargetFrames ? Stats.TargetFrames - Stats.FillFrames : 0;
+	}
+#endif
+
+	// A pre-encoded Bluetooth clip replaces the mixer output; the mixer is
+	// still rendered so its voices keep their timing.
+	const bool bClipPlaying = Context->ConnectionType == EDSDeviceConnection::Bluetooth && AdvanceBluetoothClip(Frames);
+
+	constexpr std::uint32_t ChunkFrames = 256;
+	float Chunk[ChunkFrames * 2];
+	while (Frames > 0)
+	{
+		const std::uint32_t Count = std::min(Frames, ChunkFrames);
+		HapticsMixer.Render(Chunk, Count);
+		if (!bClipPlaying)
+		{
+			AudioHapticUpdate(std::span<const float>(Chunk, static_cast<std::size_t>(Count) * 2));
+		}
+		Frames -= Count;
+	}
+}
+
+bool FDualSenseLibrary::PlayHapticClip(const FHapticClipView& Clip, std::uint8_t Priority, float Gain)
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!Context || !Context->IsConnected)
+	{
+		return false;
+	}
+
+	if (Context->ConnectionType == EDSDeviceConnection::Bluetooth && !Clip.Packets.empty())
+	{
+		BluetoothClipSequence.fetch_add(1, std::memory_order_acq_rel);
+		BluetoothClipRequest.store(Clip.Packets.data(), std::memory_order_relaxed);
+		BluetoothClipRequestPackets.store(Clip.Packets.size() / FHapticBankFormat::PacketSize, std::memory_order_relaxed);
+		BluetoothClipSequence.fetch_add(1, std::memory_order_release);
+		return true;
+	}
+
+	// The mixer plays PCM as is: a clip compiled for another rate would play
+	// at the wrong pitch and speed. Packets are paced at the controller rate,
+	// so Bluetooth accepts any.
+	if (Clip.SampleRate != 0 && Clip.SampleRate != RequestedHapticsSampleRate.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	return HapticsMixer.PlayClip(Clip.Pcm, Priority, Gain) != FGamepadHapticsMixer::InvalidVoice;
+}
+
+std::int32_t FDualSenseLibrary::ScheduleHapticClip(std::span<const float> Interleaved, std::uint64_t HostTimeUs, std::uint8_t Priority, float Gain)
+{
+	return HapticsMixer.PlayClip(Interleaved, Priority, Gain, HostTimeToMixerFrame(HostTimeUs));
+}
+
+std::int32_t FDualSenseLibrary::ScheduleHapticStream(std::uint64_t HostTimeUs, std::uint8_t Priority, float Gain)
+{
+	return HapticsMixer.CreateStream(Priority, Gain, HostTimeToMixerFrame(HostTimeUs));
+}
+
+std::uint64_t FDualSenseLibrary::HostTimeToMixerFrame(std::uint64_t HostTimeUs)
+{
+	// The next mixer frame is rendered and sent right away over Bluetooth;
+	// over USB it lands on the next queue position, whose play time the
+	// device clock gives.
+	const std::uint64_t NextFrame = HapticsMixer.GetRenderedFrames();
+	std::uint64_t NextFrameUs = gc_time::now_us();
+#if GAMEPAD_CORE_HAS_AUDIO
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (Context && Context->ConnectionType != EDSDeviceConnection::Bluetooth && Context->AudioContext && Context->AudioContext->IsValid())
+	{
+		std::uint64_t QueueFrameUs = 0;
+		if (Context->AudioContext->EstimateHostTimeUs(Context->AudioContext->GetWrittenFrames(), QueueFrameUs))
+		{
+			NextFrameUs = QueueFrameUs;
+		}
+	}
+#endif
+
+	if (HostTimeUs <= NextFrameUs)
+	{
+		return NextFrame;
+	}
+
+	const std::uint64_t DelayUs = HostTimeUs - NextFrameUs;
+	return NextFrame + ((DelayUs * RequestedHapticsSampleRate.load(std::memory_order_relaxed)) / 1000000);
+}
+
+bool FDualSenseLibrary::AdvanceBluetoothClip(std::uint32_t Frames)
+{
+	// Pick up a clip requested since the last call, unless the request is
+	// being written right now; it is then taken on the next call.
+	const std::uint32_t Sequence = BluetoothClipSequence.load(std::memory_order_acquire);
+	if ((Sequence & 1) == 0 && Sequence != BluetoothClipAccepted)
+	{
+		const std::uint8_t* Packets = BluetoothClipRequest.load(std::memory_order_relaxed);
+		const std::size_t Count = BluetoothClipRequestPackets.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (BluetoothClipSequence.load(std::memory_order_relaxed) == Sequence)
+		{
+			BluetoothClipAccepted = Sequence;
+			BluetoothClipPackets = Packets;
+			BluetoothClipRemaining = Count;
+			BluetoothClipDebt = 0;
+		}
+	}
+
+	if (BluetoothClipRemaining == 0)
+	{
+		return false;
+	}
+
+	// A packet holds FramesPerPacket frames at the controller rate, i.e.
+	// FramesPerPacket * InputRate / OutputRate frames of haptics time.
+	const std::uint64_t PacketCost = static_cast<std::uint64_t>(FGamepadHapticsEncoder::FramesPerPacket) * HapticsEncoder.GetInputSampleRate();
+	BluetoothClipDebt += static_cast<std::uint64_t>(Frames) * FGamepadHapticsEncoder::OutputSampleRate;
+	while (BluetoothClipRemaining > 0 && BluetoothClipDebt >= PacketCost)
+	{
+		AudioHapticUpdate(std::span<const std::uint8_t, 64>(BluetoothClipPackets, 64));
+		BluetoothClipPackets += FHapticBankFormat::PacketSize;
+		--BluetoothClipRemaining;
+		BluetoothClipDebt -= PacketCost;
+	}
+	return true;
+}
+
+void FDualSenseLibrary::SetHapticsLatency(const FHapticsLatencyConfig& Latency)
+{
+#if GAMEPAD_CORE_HAS_AUDIO
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!Context || !Context->AudioContext)
+	{
+		return;
+	}
+
+	Context->AudioContext->SetLatency(Latency);
+#else
+	(void)Latency;
+#endif
+}
+
+bool FDualSenseLibrary::GetHapticsStats(FHapticsBufferStats& OutStats)
+{
+#if GAMEPAD_CORE_HAS_AUDIO
 	FDeviceContext* Context = GetMutableDeviceContext();
 	if (!Context || !Context->AudioContext || !Context->AudioContext->IsValid())
+	{
+		return false;
+	}
+
+	OutStats = Context->AudioContext->GetStats();
+	return true;
+#else
+	(void)OutStats;
+	return false;
+#endif
+}
+
+template<typename TSample>
+void FDualSenseLibrary::SubmitHaptics(FDeviceContext* Context, std::span<const TSample> AudioData)
+{
+	if (Context->ConnectionType == EDSDeviceConnection::Bluetooth)
+	{
+		HapticsEncoder.Encode(AudioData, [this](std::span<const std::uint8_t, 64> Packet) {
+			AudioHapticUpdate(Packet);
+		});
+		return;
+	}
+
+#if GAMEPAD_CORE_HAS_AUDIO
+	if (!Context->AudioContext || !Context->AudioContext->IsValid())
 	{
 		return;
 	}
 
-	// Use the new miniaudio-based WriteHapticData method
 	Context->AudioContext->WriteHapticData(AudioData);
+#endif
+}
+
+template<typename TSample>
+void FDualSenseLibrary::ProcessHaptics(std::span<const TSample> AudioData)
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!Context || !Context->IsConnected)
+	{
+		return;
+	}
+
+	ApplyHapticsSettings();
+	if (!HapticsDsp.IsEnabled())
+	{
+		SubmitHaptics(Context, AudioData);
+		return;
+	}
+
+	constexpr std::size_t ChunkFrames = 256;
+	float Chunk[ChunkFrames * 2];
+	const std::size_t Frames = AudioData.size() / 2;
+	for (std::size_t Offset = 0; Offset < Frames; Offset += ChunkFrames)
+	{
+		const std::size_t Count = std::min(ChunkFrames, Frames - Offset);
+		FGamepadAudio::InterleaveHaptics(&AudioData[Offset * 2], Chunk, Count, 2);
+		HapticsDsp.Process(Chunk, Count);
+		SubmitHaptics(Context, std::span<const float>(Chunk, Count * 2));
+	}
+}
+
+void FDualSenseLibrary::AudioHapticUpdate(std::span<const std::int16_t> AudioData)
+{
+	ProcessHaptics(AudioData);
+}
+
+void FDualSenseLibrary::AudioHapticUpdate(std::span<const float> AudioData)
+{
+	ProcessHaptics(AudioData);
+}
+
+template<typename TSample>
+void FDualSenseLibrary::SubmitSpeaker(std::span<const TSample> AudioData)
+{
+#if GAMEPAD_CORE_HAS_AUDIO
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!Context || !Context->IsConnected || Context->ConnectionType == EDSDeviceConnection::Bluetooth)
+	{
+		return;
+	}
+
+	if (!Context->AudioContext || !Context->AudioContext->IsValid())
+	{
+		return;
+	}
+
+	Context->AudioContext->WriteSpeakerData(AudioData);
+#else
+	(void)AudioData;
+#endif
+}
+
+void FDualSenseLibrary::AudioSpeakerUpdate(std::span<const std::int16_t> AudioData)
+{
+	SubmitSpeaker(AudioData);
+}
+
+void FDualSenseLibrary::AudioSpeakerUpdate(std::span<const float> AudioData)
+{
+	SubmitSpeaker(AudioData);
+}
+
+void FDualSenseLibrary::SetAudioStreamGains(float SpeakerGain, float HapticsGain)
+{
+#if GAMEPAD_CORE_HAS_AUDIO
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!Context || !Context->AudioContext)
+	{
+		return;
+	}
+
+	Context->AudioContext->SetStreamGains(SpeakerGain, HapticsGain);
+#else
+	(void)SpeakerGain;
+	(void)HapticsGain;
+#endif
+}
+
+bool FDualSenseLibrary::EnableBluetoothLink(const FBluetoothLinkConfig& Config)
+{
+	FDeviceContext* Context = GetMutableDeviceContext();
+	if (!Context || !Context->IsConnected || Context->ConnectionType != EDSDeviceConnection::Bluetooth)
+	{
+		return false;
+	}
+
+	return LinkScheduler.Start(this, Config);
+}
+
+void FDualSenseLibrary::DisableBluetoothLink()
+{
+	LinkScheduler.Stop();
+}
+
+bool FDualSenseLibrary::GetBluetoothLinkStats(FBluetoothLinkStats& OutStats)
+{
+	if (!LinkScheduler.IsRunning())
+	{
+		return false;
+	}
+
+	OutStats = LinkScheduler.GetStats();
+	return true;
+}
+
+FDualSenseLibrary::~FDualSenseLibrary()
+{
+	StopHapticsThreads();
+}
+
+void FDualSenseLibrary::ShutdownLibrary()
+{
+	StopHapticsThreads();
+	SonyGamepadAbstract::ShutdownLibrary();
+}
+
+void FDualSenseLibrary::StopHapticsThreads()
+{
+	// A no-op unless the integration registered the gamepad by hand.
+	FGamepadAudioEngine::Get().RemoveSource(this);
+	LinkScheduler.Stop();
+}
+
+void FDualSenseLibrary::SendOutputReport()
+{
+	WriteOutputReport(IPlatformHardwareInfo::Get());
 }
@@ -20,68 +20,70 @@ bool FDualShockLibrary::Initialize(const FDeviceContext& Context)
 }
 
 void FDualShockLibrary::UpdateOutput()
+{
+	WriteOutput(IPlatformHardwareInfo::Get());
+}
+
+bool FDualShockLibrary::PrepareOutput()
 {
 	FDeviceContext* Context = GetMutableDeviceContext();
 	if (!Context->IsConnected)
 	{
-		return;
+		return false;
 	}
 
-	FGamepadOutput::OutputDualShock(Context);
+	return FGamepadOutput::ComposeDualShock(Context);
 }
 
 void FDualShockLibrary::UpdateInput(float /*Delta*/)
 {
-	FDeviceContext* Context = GetMutableDeviceContext();
-	IPlatformHardwareInfo::Get().Read(Context);
+	ReadInput(IPlatformHardwareInfo::Get());
+}
+
+void FDualShockLibrary::DecodeInput(FDeviceContext* Context)
+{
 	FInputContext* InputToFill = Context->GetBackBuffer();
 
 	using namespace FGamepadInput;
-	const size_t Padding = Context->ConnectionType == EDSDeviceConnection::Bluetooth ? 3 : 1;
-	if (Padding == 3)
+	// Bluetooth reports arrive in the larger DualShock 4 buffer.
+	const unsigned char* Report = Context->ConnectionType == EDSDeviceConnection::Bluetooth ? &Context->BufferDS4[3] : &Context->Buffer[1];
+	DualShockRaw(Report, InputToFill);
+	if (Context->bEnableGesture || Context->bEnableTouch)
 	{
-		DualShockRaw(&Context->BufferDS4[Padding], InputToFill);
-		if (Context->bEnableGesture || Context->bEnableTouch)
-		{
-			using namespace FGamepadTouch;
-			ProcessTouchDualShock(&Context->BufferDS4[Padding], InputToFill, Context->ConnectionType);
-		}
-
-		if (Context->bEnableAccelerometerAndGyroscope)
-		{
-			DSCoreTypes::DSVector3D GyroDeg;
-			DSCoreTypes::DSVector3D AccelG;
-
-			using namespace FGamepadSensors;
-			ProcessMotionDualShock(&Context->BufferDS4[Padding], Context->Calibration, Context->ConnectionType, GyroDeg, AccelG);
-
-			InputToFill->Gyroscope = GyroDeg;
-			InputToFill->Accelerometer = AccelG;
-		}
+		using namespace FGamepadTouch;
+		ProcessTouchDualShock(Report, InputToFill, Context->ConnectionType);
 	}
-	else
+
+	DSCoreTypes::DSVector3D GyroDeg;
+	DSCoreTypes::DSVector3D AccelG;
+	const bool bDrainedMotion = DrainedMotion.Resolve(GyroDeg, AccelG);
+	if (Context->bEnableAccelerometerAndGyroscope)
 	{
-		DualShockRaw(&Context->Buffer[Padding], InputToFill);
-		if (Context->bEnableGesture || Context->bEnableTouch)
+		if (!bDrainedMotion)
 		{
-			using namespace FGamepadTouch;
-			ProcessTouchDualShock(&Context->Buffer[Padding], InputToFill, Context->ConnectionType);
+			using namespace FGamepadSensors;
+			ProcessMotionDualShock(Report, Context->Calibration, Context->ConnectionType, GyroDeg, AccelG);
 		}
 
-		if (Context->bEnableAccelerometerAndGyroscope)
-		{
-			DSCoreTypes::DSVector3D GyroDeg;
-			DSCoreTypes::DSVector3D AccelG;
+		InputToFill->Gyroscope = GyroDeg;
+		InputToFill->Accelerometer = AccelG;
+	}
 
-			using namespace FGamepadSensors;
-			ProcessMotionDualShock(&Context->Buffer[Padding], Context->Calibration, Context->ConnectionType, GyroDeg, AccelG);
+	Context->SwapInputBuffers();
+}
 
-			InputToFill->Gyroscope = GyroDeg;
-			InputToFill->Accelerometer = AccelG;
-		}
+void FDualShockLibrary::OnInputReport(FDeviceContext* Context)
+{
+	if (!Context->bEnableAccelerometerAndGyroscope)
+	{
+		return;
 	}
 
-	Context->SwapInputBuffers();
+	const unsigned char* Report = Context->ConnectionType == EDSDeviceConnection::Bluetooth ? &Context->BufferDS4[3] : &Context->Buffer[1];
+	DSCoreTypes::DSVector3D GyroDeg;
+	DSCoreTypes::DSVector3D AccelG;
+	FGamepadSensors::ProcessMotionDualShock(Report, Context->Calibration, Context->ConnectionType, GyroDeg, AccelG);
+	DrainedMotion.Add(GyroDeg, AccelG);
 }
 
 void FDualShockLibrary::SetVibration(std::uint8_t LeftRumble, std::uint8_t RightRumble)
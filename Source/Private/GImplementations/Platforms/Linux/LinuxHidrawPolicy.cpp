@@ -0,0 +1,975 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+
+#include "GImplementations/Platforms/Linux/LinuxHidrawPolicy.h"
+
+#if defined(__linux__) && !defined(GAMEPAD_CORE_EMBEDDED)
+#include "GCore/Templates/TGenericHardwareInfo.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <linux/hidraw.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(GamepadCore::IsHardwarePolicy<FLinuxHidrawPolicy>);
+static_assert(GamepadCore::HasBatchWrite<FLinuxHidrawPolicy>);
+static_assert(GamepadCore::HasPollDescriptor<FLinuxHidrawPolicy>);
+static_assert(GamepadCore::HasReadAll<FLinuxHidrawPolicy>);
+
+namespace
+{
+	constexpr std::uint16_t SonyVendorId = 0x054C;
+	constexpr std::uint16_t DualSenseProductId = 0x0CE6;
+	constexpr std::uint16_t DualSenseEdgeProductId = 0x0DF2;
+	constexpr std::uint16_t DualShock4ProductId = 0x05C4;
+	constexpr std::uint16_t DualShock4V2ProductId = 0x09CC;
+	constexpr std::uint32_t BusUsb = 0x03;
+	constexpr std::uint32_t BusBluetooth = 0x05;
+
+	/** Longest input report: the Bluetooth report of both controllers. */
+	constexpr std::uint32_t InputReportSize = 78;
+	/** Longest output report: the Bluetooth audio haptics report. */
+	constexpr std::size_t WriteSlotSize = 144;
+	/** Reports the kernel queues per hidraw reader. */
+	constexpr std::size_t HidrawQueueLength = 64;
+
+	/**
+	 * Minimal io_uring over the raw system calls, so liburing is not needed.
+	 * Not thread-safe; the policy serializes access.
+	 */
+	class FIoUring
+	{
+	public:
+		FIoUring() = default;
+		FIoUring(const FIoUring&) = delete;
+		FIoUring& operator=(const FIoUring&) = delete;
+
+		~FIoUring()
+		{
+			if (Sqes)
+			{
+				munmap(Sqes, SqesSize);
+			}
+			if (CqRing && CqRing != SqRing)
+			{
+				munmap(CqRing, CqRingSize);
+			}
+			if (SqRing)
+			{
+				munmap(SqRing, SqRingSize);
+			}
+			if (Fd >= 0)
+			{
+				close(Fd);
+			}
+		}
+
+		bool Initialize(std::uint32_t Entries, std::uint32_t CompletionEntries)
+		{
+			io_uring_params Params{};
+			Params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+			Params.cq_entries = CompletionEntries;
+			Fd = static_cast<int>(syscall(__NR_io_uring_setup, Entries, &Params));
+			if (Fd < 0)
+			{
+				return false;
+			}
+
+			SqRingSize = Params.sq_off.array + Params.sq_entries * sizeof(std::uint32_t);
+			CqRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof(io_uring_cqe);
+			const bool bSingleMap = (Params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (bSingleMap)
+			{
+				SqRingSize = CqRingSize = std::max(SqRingSize, CqRingSize);
+			}
+
+			SqRing = Map(SqRingSize, IORING_OFF_SQ_RING);
+			CqRing = bSingleMap ? SqRing : Map(CqRingSize, IORING_OFF_CQ_RING);
+			SqesSize = Params.sq_entries * sizeof(io_uring_sqe);
+			Sqes = static_cast<io_uring_sqe*>(Map(SqesSize, IORING_OFF_SQES));
+			if (!SqRing || !CqRing || !Sqes)
+			{
+				return false;
+			}
+
+			auto* Sq = static_cast<std::uint8_t*>(SqRing);
+			SqHead = reinterpret_cast<std::uint32_t*>(Sq + Params.sq_off.head);
+			SqTail = reinterpret_cast<std::uint32_t*>(Sq + Params.sq_off.tail);
+			SqMask = *reinterpret_cast<std::uint32_t*>(Sq + Params.sq_off.ring_mask);
+			SqEntries = Params.sq_entries;
+			auto* Array = reinterpret_cast<std::uint32_t*>(Sq + Params.sq_off.array);
+			for (std::uint32_t Index = 0; Index < SqEntries; ++Index)
+			{
+				Array[Index] = Index;
+			}
+			LocalTail = *SqTail;
+
+			auto* Cq = static_cast<std::uint8_t*>(CqRing);
+			CqHead = reinterpret_cast<std::uint32_t*>(Cq + Params.cq_off.head);
+			CqTail = reinterpret_cast<std::uint32_t*>(Cq + Params.cq_off.tail);
+			CqMask = *reinterpret_cast<std::uint32_t*>(Cq + Params.cq_off.ring_mask);
+			Cqes = reinterpret_cast<io_uring_cqe*>(Cq + Params.cq_off.cqes);
+			return true;
+		}
+
+		bool RegisterBuffer(void* Data, std::size_t Size)
+		{
+			iovec Vector{Data, Size};
+			return syscall(__NR_io_uring_register, Fd, IORING_REGISTER_BUFFERS, &Vector, 1) == 0;
+		}
+
+		/** @return A cleared entry to prepare, or nullptr if the queue is full. */
+		io_uring_sqe* GetSqe()
+		{
+			const std::uint32_t Head = std::atomic_ref<std::uint32_t>(*SqHead).load(std::memory_order_acquire);
+			if (LocalTail - Head >= SqEntries)
+			{
+				return nullptr;
+			}
+
+			io_uring_sqe* Sqe = &Sqes[LocalTail & SqMask];
+			std::memset(Sqe, 0, sizeof(*Sqe));
+			++LocalTail;
+			++Unsubmitted;
+			return Sqe;
+		}
+
+		/**
+		 * Submits the prepared entries and optionally waits for completions.
+		 *
+		 * @return The number of entries submitted, or a negative errno.
+		 */
+		int Submit(std::uint32_t WaitCompletions)
+		{
+			std::atomic_ref<std::uint32_t>(*SqTail).store(LocalTail, std::memory_order_release);
+			if (Unsubmitted == 0 && WaitCompletions == 0)
+			{
+				return 0;
+			}
+
+			for (;;)
+			{
+				const long Result = syscall(__NR_io_uring_enter, Fd, Unsubmitted, WaitCompletions, WaitCompletions ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+				if (Result >= 0)
+				{
+					Unsubmitted -= static_cast<std::uint32_t>(Result);
+					return static_cast<int>(Result);
+				}
+				if (errno != EINTR)
+				{
+					return -errno;
+				}
+			}
+		}
+
+		/**
+		 * Hands every available completion to Func.
+		 *
+		 * @return The number of completions consumed.
+		 */
+		template<typename TFunc>
+		std::uint32_t Reap(TFunc&& Func)
+		{
+			std::atomic_ref<std::uint32_t> Head(*CqHead);
+			const std::uint32_t Tail = std::atomic_ref<std::uint32_t>(*CqTail).load(std::memory_order_acquire);
+			std::uint32_t Count = 0;
+			for (std::uint32_t Current = Head.load(std::memory_order_relaxed); Current != Tail; ++Current, ++Count)
+			{
+				const io_uring_cqe Cqe = Cqes[Current & CqMask];
+				Head.store(Current + 1, std::memory_order_release);
+				Func(Cqe);
+			}
+			return Count;
+		}
+
+	private:
+		void* Map(std::size_t Size, std::uint64_t Offset) const
+		{
+			void* Address = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Fd, static_cast<off_t>(Offset));
+			return Address == MAP_FAILED ? nullptr : Address;
+		}
+
+		int Fd = -1;
+		void* SqRing = nullptr;
+		void* CqRing = nullptr;
+		io_uring_sqe* Sqes = nullptr;
+		io_uring_cqe* Cqes = nullptr;
+		std::size_t SqRingSize = 0;
+		std::size_t CqRingSize = 0;
+		std::size_t SqesSize = 0;
+		std::uint32_t* SqHead = nullptr;
+		std::uint32_t* SqTail = nullptr;
+		std::uint32_t* CqHead = nullptr;
+		std::uint32_t* CqTail = nullptr;
+		std::uint32_t SqMask = 0;
+		std::uint32_t CqMask = 0;
+		std::uint32_t SqEntries = 0;
+		std::uint32_t LocalTail = 0;
+		std::uint32_t Unsubmitted = 0;
+	};
+
+	enum class EIoOperation : std::uint8_t
+	{
+		Poll,
+		Write,
+		Cancel
+	};
+
+	std::uint64_t EncodeUserData(EIoOperation Operation, std::size_t Index, std::size_t Slot, std::uint32_t Generation)
+	{
+		return (static_cast<std::uint64_t>(Generation) << 32) | (static_cast<std::uint64_t>(Index) << 16) |
+		       (static_cast<std::uint64_t>(Slot) << 8) | static_cast<std::uint64_t>(Operation);
+	}
+
+	FPlatformDeviceHandle MakeHandle(std::size_t Index, std::uint32_t Generation)
+	{
+		return reinterpret_cast<FPlatformDeviceHandle>((static_cast<std::uintptr_t>(Generation) << 8) | (Index + 1));
+	}
+
+	std::uint32_t GetOutputReportSize(const FDeviceContext* Context)
+	{
+		const bool bBluetooth = Context->ConnectionType == EDSDeviceConnection::Bluetooth;
+		if (Context->DeviceType == EDSDeviceType::DualShock4)
+		{
+			return bBluetooth ? 78 : 32;
+		}
+		return bBluetooth ? 78 : 63;
+	}
+
+	/** DualShock 4 Bluetooth reports are decoded from their own buffer. */
+	unsigned char* GetInputTarget(FDeviceContext* Context)
+	{
+		const bool bDualShock4Bluetooth = Context->DeviceType == EDSDeviceType::DualShock4 && Context->ConnectionType == EDSDeviceConnection::Bluetooth;
+		return bDualShock4Bluetooth ? Context->BufferDS4 : Context->Buffer;
+	}
+
+	/**
+	 * Reading the calibration feature report switches Bluetooth controllers
+	 * from their reduced input report to the full one.
+	 */
+	void RequestFullReports(int Fd)
+	{
+		std::uint8_t Report[64] = {0x05};
+		(void)ioctl(Fd, HIDIOCGFEATURE(sizeof(Report)), Report);
+	}
+
+	void ScanSysfs(std::vector<FDeviceContext>& Devices)
+	{
+		DIR* Directory = opendir("/sys/class/hidraw");
+		if (!Directory)
+		{
+			return;
+		}
+
+		while (const dirent* Entry = readdir(Directory))
+		{
+			const std::string Name = Entry->d_name;
+			if (!Name.starts_with("hidraw"))
+			{
+				continue;
+			}
+
+			std::ifstream Uevent("/sys/class/hidraw/" + Name + "/device/uevent");
+			std::string Line;
+			std::uint32_t Bus = 0;
+			std::uint32_t Vendor = 0;
+			std::uint32_t Product = 0;
+			bool bFound = false;
+			while (std::getline(Uevent, Line))
+			{
+				if (Line.starts_with("HID_ID=") && std::sscanf(Line.c_str() + 7, "%x:%x:%x", &Bus, &Vendor, &Product) == 3)
+				{
+					bFound = true;
+					break;
+				}
+			}
+
+			if (!bFound || Vendor != SonyVendorId || (Bus != BusUsb && Bus != BusBluetooth))
+			{
+				continue;
+			}
+
+			FDeviceContext Context;
+			switch (Product)
+			{
+				case DualSenseProductId: Context.DeviceType = EDSDeviceType::DualSense; break;
+				case DualSenseEdgeProductId: Context.DeviceType = EDSDeviceType::DualSenseEdge; break;
+				case DualShock4ProductId:
+				case DualShock4V2ProductId: Context.DeviceType = EDSDeviceType::DualShock4; break;
+				default: continue;
+			}
+			Context.ConnectionType = Bus == BusBluetooth ? EDSDeviceConnection::Bluetooth : EDSDeviceConnection::Usb;
+			Context.Path = "/dev/" + Name;
+			Devices.push_back(std::move(Context));
+		}
+		closedir(Directory);
+	}
+} // namespace
+
+struct FLinuxHidrawPolicy::FImpl
+{
+	struct FDevice
+	{
+		int ReadFd = -1;
+		int WriteFd = -1;
+		/** Bumped on close, so handles and completions of a closed device are ignored. */
+		std::uint32_t Generation = 0;
+		/** Polls and writes submitted and not yet completed. */
+		std::uint32_t InFlight = 0;
+		std::uint32_t WriteHead = 0;
+		std::uint32_t WriteCount = 0;
+		std::array<std::uint32_t, WritesPerDevice> WriteLengths{};
+		std::array<bool, WritesPerDevice> WriteIsOutput{};
+		bool bWriteInFlight = false;
+		bool bPollArmed = false;
+		/** Set by a poll completion; the next read drains the descriptor. */
+		bool bReadable = true;
+		bool bClosing = false;
+		bool bFailed = false;
+
+		bool IsOpen() const { return ReadFd >= 0; }
+	};
+
+	struct FFakeDevice
+	{
+		std::string Path;
+		EDSDeviceType DeviceType;
+		EDSDeviceConnection ConnectionType;
+		/** Policy ends: input is read from here, output written there. */
+		int InputFd;
+		int OutputFd;
+	};
+
+	static constexpr std::size_t WriteArenaSize = MaxDevices * WritesPerDevice * WriteSlotSize;
+
+	gc_lock::mutex Mutex;
+	FIoUring Ring;
+	bool bUring = false;
+	bool bFixedBuffers = false;
+	/** Cleared when the kernel predates multishot polls; polls are re-armed after each read. */
+	bool bMultishotPoll = true;
+	bool bScanSysfs = true;
+	std::unique_ptr<std::uint8_t[]> Arena;
+	std::array<FDevice, MaxDevices> Devices;
+	std::vector<FFakeDevice> FakeDevices;
+
+	FImpl()
+	    : Arena(std::make_unique<std::uint8_t[]>(WriteArenaSize))
+	{
+		const std::uint32_t Entries = static_cast<std::uint32_t>(MaxDevices * (WritesPerDevice + 2) * 2);
+		bUring = Ring.Initialize(Entries, Entries * 4);
+		bFixedBuffers = bUring && Ring.RegisterBuffer(Arena.get(), WriteArenaSize);
+	}
+
+	~FImpl()
+	{
+		for (std::size_t Index = 0; Index < MaxDevices; ++Index)
+		{
+			if (Devices[Index].IsOpen())
+			{
+				CloseDevice(Index);
+			}
+		}
+		for (const FFakeDevice& Fake : FakeDevices)
+		{
+			close(Fake.InputFd);
+			close(Fake.OutputFd);
+		}
+	}
+
+	std::uint8_t* GetWriteSlot(std::size_t Index, std::size_t Slot) const
+	{
+		return &Arena[(Index * WritesPerDevice + Slot) * WriteSlotSize];
+	}
+
+	/** @return The index of the open device behind a handle, or -1. */
+	int FindDevice(const FDeviceContext* Context) const
+	{
+		const std::size_t Index = (reinterpret_cast<std::uintptr_t>(Context->Handle) & 0xFF) - 1;
+		if (Index >= MaxDevices)
+		{
+			return -1;
+		}
+
+		const FDevice& Device = Devices[Index];
+		return Device.IsOpen() && Context->Handle == MakeHandle(Index, Device.Generation) ? static_cast<int>(Index) : -1;
+	}
+
+	io_uring_sqe* AcquireSqe()
+	{
+		io_uring_sqe* Sqe = Ring.GetSqe();
+		if (!Sqe && Ring.Submit(0) >= 0)
+		{
+			Sqe = Ring.GetSqe();
+		}
+		return Sqe;
+	}
+
+	/**
+	 * Watches a device for input. hidraw cannot read without blocking an
+	 * io-wq worker, so the ring only reports readiness and the reads are
+	 * non-blocking calls on the submitting thread.
+	 */
+	void ArmPoll(std::size_t Index)
+	{
+		FDevice& Device = Devices[Index];
+		io_uring_sqe* Sqe = AcquireSqe();
+		if (!Sqe)
+		{
+			return;
+		}
+
+		Sqe->opcode = IORING_OP_POLL_ADD;
+		Sqe->fd = Device.ReadFd;
+		Sqe->poll32_events = POLLIN;
+		Sqe->len = bMultishotPoll ? IORING_POLL_ADD_MULTI : 0u;
+		Sqe->user_data = EncodeUserData(EIoOperation::Poll, Index, 0, Device.Generation);
+		Device.bPollArmed = true;
+		++Device.InFlight;
+	}
+
+	void SubmitNextWrite(std::size_t Index)
+	{
+		FDevice& Device = Devices[Index];
+		if (Device.bWriteInFlight || Device.WriteCount == 0)
+		{
+			return;
+		}
+
+		io_uring_sqe* Sqe = AcquireSqe();
+		if (!Sqe)
+		{
+			return;
+		}
+
+		// Forced async so a slow Bluetooth write never blocks the submitter.
+		Sqe->opcode = bFixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+		Sqe->flags = IOSQE_ASYNC;
+		Sqe->fd = Device.WriteFd;
+		Sqe->addr = reinterpret_cast<std::uintptr_t>(GetWriteSlot(Index, Device.WriteHead));
+		Sqe->len = Device.WriteLengths[Device.WriteHead];
+		Sqe->user_data = EncodeUserData(EIoOperation::Write, Index, Device.WriteHead, Device.Generation);
+		Device.bWriteInFlight = true;
+		++Device.InFlight;
+	}
+
+	void Cancel(std::size_t Index, std::uint64_t Target)
+	{
+		if (io_uring_sqe* Sqe = AcquireSqe())
+		{
+			Sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			Sqe->fd = -1;
+			Sqe->addr = Target;
+			Sqe->user_data = EncodeUserData(EIoOperation::Cancel, Index, 0, Devices[Index].Generation);
+		}
+	}
+
+	void OnCompletion(const io_uring_cqe& Cqe)
+	{
+		const auto Operation = static_cast<EIoOperation>(Cqe.user_data & 0xFF);
+		const std::size_t Index = (Cqe.user_data >> 16) & 0xFFFF;
+		if (Operation == EIoOperation::Cancel || Index >= MaxDevices)
+		{
+			return;
+		}
+
+		// A multishot poll stays armed while the kernel flags more completions.
+		FDevice& Device = Devices[Index];
+		const bool bMore = (Cqe.flags & IORING_CQE_F_MORE) != 0;
+		if (!bMore)
+		{
+			--Device.InFlight;
+		}
+		if (Device.Generation != static_cast<std::uint32_t>(Cqe.user_data >> 32))
+		{
+			return;
+		}
+
+		if (Operation == EIoOperation::Poll)
+		{
+			Device.bPollArmed = bMore;
+			if (Device.bClosing || Cqe.res == -ECANCELED)
+			{
+				return;
+			}
+			if (Cqe.res == -EINVAL && bMultishotPoll)
+			{
+				bMultishotPoll = false;
+			}
+
+			// Readiness, hang-up and errors alike are found by the next read.
+			Device.bReadable = true;
+			return;
+		}
+
+		Device.bWriteInFlight = false;
+		Device.WriteHead = (Device.WriteHead + 1) % WritesPerDevice;
+		--Device.WriteCount;
+		if (Cqe.res < 0 && Cqe.res != -EAGAIN && Cqe.res != -ECANCELED)
+		{
+			Device.bFailed = true;
+		}
+		if (!Device.bClosing)
+		{
+			SubmitNextWrite(Index);
+		}
+	}
+
+	std::uint32_t ReapCompletions()
+	{
+		return Ring.Reap([this](const io_uring_cqe& Cqe) {
+			OnCompletion(Cqe);
+		});
+	}
+
+	/**
+	 * @return True if a device may have queued reports: always without the
+	 * ring, otherwise once a poll completed since the last drain.
+	 */
+	bool BeginRead(std::size_t Index)
+	{
+		if (!bUring)
+		{
+			return true;
+		}
+
+		ReapCompletions();
+		FDevice& Device = Devices[Index];
+		if (!Device.bReadable)
+		{
+			return false;
+		}
+
+		// Cleared before reading: a report arriving after the drain
+		// completes the poll again.
+		Device.bReadable = false;
+		return true;
+	}
+
+	/**
+	 * Reads one queued report of a device into Target, in arrival order.
+	 *
+	 * @return False once the queue is empty or the device failed.
+	 */
+	bool ReadReport(std::size_t Index, unsigned char* Target)
+	{
+		FDevice& Device = Devices[Index];
+		for (;;)
+		{
+			const ssize_t Result = read(Device.ReadFd, Target, InputReportSize);
+			if (Result > 0)
+			{
+				return true;
+			}
+			if (Result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (Result == 0 || errno != EAGAIN)
+			{
+				// End of file or the device is gone.
+				Device.bFailed = true;
+			}
+			return false;
+		}
+	}
+
+	/** Re-arms the poll of a drained device if it has ended. */
+	void EndRead(std::size_t Index)
+	{
+		FDevice& Device = Devices[Index];
+		if (bUring && !Device.bPollArmed && !Device.bFailed)
+		{
+			ArmPoll(Index);
+			Ring.Submit(0);
+		}
+	}
+
+	void EnqueueWrite(std::size_t Index, const unsigned char* Data, std::uint32_t Length, bool bOutputReport)
+	{
+		FDevice& Device = Devices[Index];
+		Length = std::min<std::uint32_t>(Length, WriteSlotSize);
+		if (!bUring)
+		{
+			if (write(Device.WriteFd, Data, Length) < 0 && errno != EAGAIN)
+			{
+				Device.bFailed = true;
+			}
+			return;
+		}
+
+		// A waiting output report is superseded by the newer one.
+		if (bOutputReport && Device.WriteCount > (Device.bWriteInFlight ? 1u : 0u))
+		{
+			const std::uint32_t Last = (Device.WriteHead + Device.WriteCount - 1) % WritesPerDevice;
+			if (Device.WriteIsOutput[Last])
+			{
+				std::memcpy(GetWriteSlot(Index, Last), Data, Length);
+				Device.WriteLengths[Last] = Length;
+				return;
+			}
+		}
+
+		while (Device.WriteCount == WritesPerDevice)
+		{
+			ReapCompletions();
+			if (Device.WriteCount < WritesPerDevice)
+			{
+				break;
+			}
+			if (Device.bFailed || Ring.Submit(1) < 0)
+			{
+				return;
+			}
+		}
+
+		const std::uint32_t Slot = (Device.WriteHead + Device.WriteCount) % WritesPerDevice;
+		std::memcpy(GetWriteSlot(Index, Slot), Data, Length);
+		Device.WriteLengths[Slot] = Length;
+		Device.WriteIsOutput[Slot] = bOutputReport;
+		++Device.WriteCount;
+		SubmitNextWrite(Index);
+	}
+
+	void CloseDevice(std::size_t Index)
+	{
+		FDevice& Device = Devices[Index];
+		if (bUring)
+		{
+			Device.bClosing = true;
+			if (Device.bPollArmed)
+			{
+				Cancel(Index, EncodeUserData(EIoOperation::Poll, Index, 0, Device.Generation));
+			}
+			if (Device.bWriteInFlight)
+			{
+				Cancel(Index, EncodeUserData(EIoOperation::Write, Index, Device.WriteHead, Device.Generation));
+			}
+
+			// The kernel may still fill the slots until every operation ends.
+			Ring.Submit(0);
+			while (Device.InFlight > 0)
+			{
+				ReapCompletions();
+				if (Device.InFlight == 0 || Ring.Submit(1) < 0)
+				{
+					break;
+				}
+			}
+		}
+
+		if (Device.WriteFd != Device.ReadFd)
+		{
+			close(Device.WriteFd);
+		}
+		close(Device.ReadFd);
+
+		const std::uint32_t Generation = Device.Generation + 1;
+		const std::uint32_t InFlight = Device.InFlight;
+		Device = FDevice{};
+		Device.Generation = Generation;
+		Device.InFlight = InFlight;
+	}
+
+	bool OpenDevice(const FDeviceContext* Context, FDevice& Device) const
+	{
+		auto Fake = std::ranges::find_if(FakeDevices, [Context](const FFakeDevice& Entry) {
+			return Entry.Path == Context->Path;
+		});
+		if (Fake != FakeDevices.end())
+		{
+			Device.ReadFd = fcntl(Fake->InputFd, F_DUPFD_CLOEXEC, 0);
+			Device.WriteFd = fcntl(Fake->OutputFd, F_DUPFD_CLOEXEC, 0);
+			if (Device.ReadFd < 0 || Device.WriteFd < 0)
+			{
+				close(Device.ReadFd);
+				close(Device.WriteFd);
+				Device.ReadFd = Device.WriteFd = -1;
+				return false;
+			}
+			fcntl(Device.ReadFd, F_SETFL, fcntl(Device.ReadFd, F_GETFL) | O_NONBLOCK);
+			return true;
+		}
+
+		// Reads never block, with or without the ring; writes through the
+		// ring run on io-wq workers regardless.
+		const int Fd = open(Context->Path.c_str(), O_RDWR | O_CLOEXEC | O_NONBLOCK);
+		if (Fd < 0)
+		{
+			return false;
+		}
+		if (Context->ConnectionType == EDSDeviceConnection::Bluetooth)
+		{
+			RequestFullReports(Fd);
+		}
+		Device.ReadFd = Device.WriteFd = Fd;
+		return true;
+	}
+};
+
+FLinuxHidrawPolicy::FLinuxHidrawPolicy()
+    : Impl(std::make_unique<FImpl>())
+{
+}
+
+FLinuxHidrawPolicy::~FLinuxHidrawPolicy() = default;
+
+void FLinuxHidrawPolicy::Read(FDeviceContext* Context)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	const int Index = Impl->FindDevice(Context);
+	if (Index < 0)
+	{
+		return;
+	}
+
+	// Drain the queued reports; the newest one is left in the buffer.
+	const auto DeviceIndex = static_cast<std::size_t>(Index);
+	if (Impl->BeginRead(DeviceIndex))
+	{
+		unsigned char* Target = GetInputTarget(Context);
+		while (Impl->ReadReport(DeviceIndex, Target))
+		{
+		}
+		Impl->EndRead(DeviceIndex);
+	}
+
+	if (Impl->Devices[DeviceIndex].bFailed)
+	{
+		Context->IsConnected = false;
+	}
+}
+
+std::size_t FLinuxHidrawPolicy::ReadAll(FDeviceContext* Context, IInputReportSink* Sink)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	const int Index = Impl->FindDevice(Context);
+	if (Index < 0)
+	{
+		return 0;
+	}
+
+	// The sink runs unlocked, as it may write to the device. Stops if the
+	// device was closed meanwhile.
+	std::size_t Count = 0;
+	auto Deliver = [this, Context, Sink, Index, &Count]() {
+		++Count;
+		Impl->Mutex.unlock();
+		Sink->OnInputReport(Context);
+		Impl->Mutex.lock();
+		return Impl->FindDevice(Context) == Index;
+	};
+
+	const auto DeviceIndex = static_cast<std::size_t>(Index);
+	if (Impl->BeginRead(DeviceIndex))
+	{
+		unsigned char* Target = GetInputTarget(Context);
+		while (Impl->ReadReport(DeviceIndex, Target))
+		{
+			if (!Deliver())
+			{
+				return Count;
+			}
+		}
+		Impl->EndRead(DeviceIndex);
+	}
+
+	if (Impl->Devices[DeviceIndex].bFailed)
+	{
+		Context->IsConnected = false;
+	}
+	return Count;
+}
+
+void FLinuxHidrawPolicy::Write(FDeviceContext* Context)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	const int Index = Impl->FindDevice(Context);
+	if (Index < 0)
+	{
+		return;
+	}
+
+	Impl->EnqueueWrite(static_cast<std::size_t>(Index), Context->GetRawOutputBuffer(), GetOutputReportSize(Context), true);
+	if (Impl->bUring)
+	{
+		Impl->Ring.Submit(0);
+	}
+}
+
+void FLinuxHidrawPolicy::WriteBatch(std::span<FDeviceContext*> Contexts)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	for (FDeviceContext* Context : Contexts)
+	{
+		const int Index = Impl->FindDevice(Context);
+		if (Index >= 0)
+		{
+			Impl->EnqueueWrite(static_cast<std::size_t>(Index), Context->GetRawOutputBuffer(), GetOutputReportSize(Context), true);
+		}
+	}
+
+	if (Impl->bUring)
+	{
+		Impl->Ring.Submit(0);
+	}
+}
+
+void FLinuxHidrawPolicy::Detect(std::vector<FDeviceContext>& Devices)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	if (Impl->bScanSysfs)
+	{
+		ScanSysfs(Devices);
+	}
+
+	for (const FImpl::FFakeDevice& Fake : Impl->FakeDevices)
+	{
+		FDeviceContext Context;
+		Context.Path = Fake.Path;
+		Context.DeviceType = Fake.DeviceType;
+		Context.ConnectionType = Fake.ConnectionType;
+		Devices.push_back(std::move(Context));
+	}
+}
+
+bool FLinuxHidrawPolicy::CreateHandle(FDeviceContext* Context)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	auto Free = std::ranges::find_if(Impl->Devices, [](const FImpl::FDevice& Device) {
+		return !Device.IsOpen() && Device.InFlight == 0;
+	});
+	if (Free == Impl->Devices.end() || !Impl->OpenDevice(Context, *Free))
+	{
+		return false;
+	}
+
+	const auto Index = static_cast<std::size_t>(Free - Impl->Devices.begin());
+	Context->Handle = MakeHandle(Index, Free->Generation);
+	Context->IsConnected = true;
+
+	if (Impl->bUring)
+	{
+		Impl->ArmPoll(Index);
+		Impl->Ring.Submit(0);
+	}
+	return true;
+}
+
+void FLinuxHidrawPolicy::InvalidateHandle(FDeviceContext* Context)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	const int Index = Impl->FindDevice(Context);
+	if (Index >= 0)
+	{
+		Impl->CloseDevice(static_cast<std::size_t>(Index));
+	}
+	Context->Handle = INVALID_PLATFORM_HANDLE;
+	Context->IsConnected = false;
+}
+
+void FLinuxHidrawPolicy::ProcessAudioHaptic(FDeviceContext* Context)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	const int Index = Impl->FindDevice(Context);
+	if (Index < 0)
+	{
+		return;
+	}
+
+	Impl->EnqueueWrite(static_cast<std::size_t>(Index), Context->BufferAudio, sizeof(Context->BufferAudio), false);
+	if (Impl->bUring)
+	{
+		Impl->Ring.Submit(0);
+	}
+}
+
+void FLinuxHidrawPolicy::InitializeAudioDevice(FDeviceContext* Context)
+{
+	// USB audio haptics go through the sound card, which hidraw does not cover.
+	(void)Context;
+}
+
+std::intptr_t FLinuxHidrawPolicy::GetPollDescriptor(FDeviceContext* Context)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	const int Index = Impl->FindDevice(Context);
+	if (Index < 0 || Impl->bUring)
+	{
+		return -1;
+	}
+	return Impl->Devices[Index].ReadFd;
+}
+
+bool FLinuxHidrawPolicy::IsUsingIoUring() const
+{
+	return Impl->bUring;
+}
+
+void FLinuxHidrawPolicy::SetSysfsScan(bool bEnabled)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	Impl->bScanSysfs = bEnabled;
+}
+
+bool FLinuxHidrawPolicy::AddFakeDevice(const std::string& Path, EDSDeviceType DeviceType, EDSDeviceConnection ConnectionType, FFakeDeviceEnds& OutEnds)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	if (std::ranges::any_of(Impl->FakeDevices, [&Path](const FImpl::FFakeDevice& Fake) { return Fake.Path == Path; }))
+	{
+		return false;
+	}
+
+	// Packet-mode pipes keep report boundaries, like hidraw.
+	int Input[2];
+	int Output[2];
+	if (pipe2(Input, O_DIRECT | O_CLOEXEC) != 0)
+	{
+		return false;
+	}
+	if (pipe2(Output, O_DIRECT | O_CLOEXEC) != 0)
+	{
+		close(Input[0]);
+		close(Input[1]);
+		return false;
+	}
+
+	// Each packet takes a pipe buffer; queue as many reports as hidraw does.
+	fcntl(Input[1], F_SETPIPE_SZ, static_cast<int>(HidrawQueueLength * sysconf(_SC_PAGESIZE)));
+
+	// Output reports the test does not read are dropped instead of blocking.
+	fcntl(Output[1], F_SETFL, fcntl(Output[1], F_GETFL) | O_NONBLOCK);
+	Impl->FakeDevices.push_back({Path, DeviceType, ConnectionType, Input[0], Output[1]});
+	OutEnds.InputFd = Input[1];
+	OutEnds.OutputFd = Output[0];
+	return true;
+}
+
+void FLinuxHidrawPolicy::RemoveFakeDevice(const std::string& Path)
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(Impl->Mutex);
+	std::erase_if(Impl->FakeDevices, [&Path](const FImpl::FFakeDevice& Fake) {
+		if (Fake.Path != Path)
+		{
+			return false;
+		}
+		close(Fake.InputFd);
+		close(Fake.OutputFd);
+		return true;
+	});
+}
+
+#endif
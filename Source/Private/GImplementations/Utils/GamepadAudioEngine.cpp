@@ -0,0 +1,229 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+
+#include "GImplementations/Utils/GamepadAudioEngine.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+	/**
+	 * Raises the calling thread to a real-time priority when the process is
+	 * allowed to; otherwise the thread keeps its default priority.
+	 */
+	void RaiseRenderThreadPriority()
+	{
+#if defined(GAMEPAD_CORE_EMBEDDED)
+#elif defined(_WIN32)
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#elif defined(__unix__) || defined(__APPLE__)
+		sched_param Param{};
+		Param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+		pthread_setschedparam(pthread_self(), SCHED_FIFO, &Param);
+#endif
+	}
+} // namespace
+
+FGamepadAudioEngine& FGamepadAudioEngine::Get()
+{
+	static FGamepadAudioEngine Engine;
+	return Engine;
+}
+
+FGamepadAudioEngine::~FGamepadAudioEngine()
+{
+	Stop();
+#if GAMEPAD_CORE_HAS_AUDIO
+	if (bContextInitialized)
+	{
+		ma_context_uninit(&AudioContext);
+	}
+#endif
+}
+
+bool FGamepadAudioEngine::Start(std::uint32_t InSampleRate, std::uint32_t InPeriodMs)
+{
+#if defined(GAMEPAD_CORE_EMBEDDED)
+	(void)InSampleRate;
+	(void)InPeriodMs;
+	return false;
+#else
+	if (bRunning.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	SampleRate = std::max<std::uint32_t>(InSampleRate, 1);
+	PeriodMs = std::max<std::uint32_t>(InPeriodMs, 1);
+	StartUs = gc_time::now_us();
+	ClockFrames.store(0, std::memory_order_release);
+	bRunning.store(true, std::memory_order_release);
+	Thread = std::thread(&FGamepadAudioEngine::Run, this);
+	return true;
+#endif
+}
+
+void FGamepadAudioEngine::Stop()
+{
+	bRunning.store(false, std::memory_order_release);
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	if (Thread.joinable())
+	{
+		Thread.join();
+	}
+#endif
+}
+
+bool FGamepadAudioEngine::AddSource(IGamepadAudioHaptics* Source)
+{
+	if (!Source)
+	{
+		return false;
+	}
+
+	for (const std::atomic<IGamepadAudioHaptics*>& Slot : Sources)
+	{
+		if (Slot.load(std::memory_order_acquire) == Source)
+		{
+			return false;
+		}
+	}
+
+	for (std::atomic<IGamepadAudioHaptics*>& Slot : Sources)
+	{
+		IGamepadAudioHaptics* Expected = nullptr;
+		if (Slot.compare_exchange_strong(Expected, Source, std::memory_order_acq_rel))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FGamepadAudioEngine::RemoveSource(IGamepadAudioHaptics* Source)
+{
+	if (!Source)
+	{
+		return;
+	}
+
+	bool bRemoved = false;
+	for (std::atomic<IGamepadAudioHaptics*>& Slot : Sources)
+	{
+		IGamepadAudioHaptics* Expected = Source;
+		bRemoved |= Slot.compare_exchange_strong(Expected, nullptr);
+	}
+
+	if (bRemoved)
+	{
+		WaitForPass();
+	}
+}
+
+void FGamepadAudioEngine::WaitForPass()
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	// Only a pass that started before the slot was cleared can still hold
+	// the source; later passes no longer see it.
+	if (Thread.get_id() == std::this_thread::get_id())
+	{
+		return;
+	}
+
+	const std::uint64_t Sequence = PassSequence.load();
+	if ((Sequence & 1) == 0)
+	{
+		return;
+	}
+
+	while (PassSequence.load(std::memory_order_acquire) == Sequence)
+	{
+		std::this_thread::yield();
+	}
+#endif
+}
+
+void FGamepadAudioEngine::Tick()
+{
+	// Frames due on the shared clock since the last pass, bounded so a long
+	// stall does not turn into a burst.
+	const std::uint64_t ElapsedUs = gc_time::now_us() - StartUs;
+	const std::uint64_t DueFrames = (ElapsedUs * SampleRate) / 1000000;
+	const std::uint64_t MaxFrames = (static_cast<std::uint64_t>(SampleRate) * PeriodMs * MaxCatchUpPeriods) / 1000;
+	const std::uint64_t Rendered = ClockFrames.load(std::memory_order_relaxed);
+	if (DueFrames <= Rendered)
+	{
+		return;
+	}
+
+	const std::uint32_t Frames = static_cast<std::uint32_t>(std::min(DueFrames - Rendered, MaxFrames));
+
+	PassSequence.fetch_add(1);
+	for (std::atomic<IGamepadAudioHaptics*>& Slot : Sources)
+	{
+		if (IGamepadAudioHaptics* Source = Slot.load())
+		{
+			Source->RenderHapticsMixer(Frames);
+		}
+	}
+	PassSequence.fetch_add(1, std::memory_order_acq_rel);
+
+	ClockFrames.store(DueFrames, std::memory_order_release);
+}
+
+void FGamepadAudioEngine::Run()
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	RaiseRenderThreadPriority();
+
+	const std::uint64_t PeriodUs = static_cast<std::uint64_t>(PeriodMs) * 1000;
+	std::uint64_t DeadlineUs = gc_time::now_us();
+	while (bRunning.load(std::memory_order_acquire))
+	{
+		Tick();
+
+		DeadlineUs += PeriodUs;
+		const std::uint64_t NowUs = gc_time::now_us();
+		if (DeadlineUs > NowUs)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(DeadlineUs - NowUs));
+		}
+		else
+		{
+			// Fell behind: restart the cadence from now instead of spinning
+			// through the missed periods.
+			DeadlineUs = NowUs;
+		}
+	}
+#endif
+}
+
+#if GAMEPAD_CORE_HAS_AUDIO
+ma_context* FGamepadAudioEngine::GetAudioContext()
+{
+	gc_lock::lock_guard<gc_lock::mutex> Lock(ContextMutex);
+	if (!bContextInitialized)
+	{
+		if (ma_context_init(nullptr, 0, nullptr, &AudioContext) != MA_SUCCESS)
+		{
+			return nullptr;
+		}
+		bContextInitialized = true;
+	}
+	return &AudioContext;
+}
+#endif
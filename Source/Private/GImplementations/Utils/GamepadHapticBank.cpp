@@ -0,0 +1,213 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+
+#include "GImplementations/Utils/GamepadHapticBank.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <string>
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace FHapticBankFormat;
+
+FGamepadHapticBank::~FGamepadHapticBank()
+{
+	Close();
+}
+
+bool FGamepadHapticBank::Open(const char* Path)
+{
+	Close();
+	if (!Path)
+	{
+		return false;
+	}
+
+#if defined(_WIN32)
+	const int WideLength = MultiByteToWideChar(CP_UTF8, 0, Path, -1, nullptr, 0);
+	if (WideLength <= 0)
+	{
+		return false;
+	}
+	std::wstring WidePath(static_cast<std::size_t>(WideLength), L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, Path, -1, WidePath.data(), WideLength);
+
+	HANDLE File = CreateFileW(WidePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+	{
+		CloseHandle(File);
+		return false;
+	}
+
+	HANDLE Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!Mapping)
+	{
+		CloseHandle(File);
+		return false;
+	}
+
+	void* View = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!View)
+	{
+		CloseHandle(Mapping);
+		CloseHandle(File);
+		return false;
+	}
+
+	FileHandle = File;
+	MappingHandle = Mapping;
+	Data = static_cast<const std::uint8_t*>(View);
+	Size = static_cast<std::size_t>(FileSize.QuadPart);
+#elif defined(__unix__) || defined(__APPLE__)
+	const int File = ::open(Path, O_RDONLY);
+	if (File < 0)
+	{
+		return false;
+	}
+
+	struct stat FileStat;
+	if (fstat(File, &FileStat) != 0 || FileStat.st_size <= 0)
+	{
+		::close(File);
+		return false;
+	}
+
+	void* View = mmap(nullptr, static_cast<std::size_t>(FileStat.st_size), PROT_READ, MAP_SHARED, File, 0);
+	// The mapping keeps the file alive; the descriptor is no longer needed.
+	::close(File);
+	if (View == MAP_FAILED)
+	{
+		return false;
+	}
+
+	Data = static_cast<const std::uint8_t*>(View);
+	Size = static_cast<std::size_t>(FileStat.st_size);
+#else
+	return false;
+#endif
+
+	if (!Validate())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FGamepadHapticBank::Close()
+{
+	if (!Data)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile(Data);
+	CloseHandle(static_cast<HANDLE>(MappingHandle));
+	CloseHandle(static_cast<HANDLE>(FileHandle));
+	MappingHandle = nullptr;
+	FileHandle = nullptr;
+#elif defined(__unix__) || defined(__APPLE__)
+	munmap(const_cast<std::uint8_t*>(Data), Size);
+#endif
+	Data = nullptr;
+	Size = 0;
+}
+
+std::uint32_t FGamepadHapticBank::GetSampleRate() const
+{
+	return Data ? reinterpret_cast<const FHapticBankHeader*>(Data)->SampleRate : 0;
+}
+
+std::uint32_t FGamepadHapticBank::GetClipCount() const
+{
+	return Data ? reinterpret_cast<const FHapticBankHeader*>(Data)->ClipCount : 0;
+}
+
+FHapticClipView FGamepadHapticBank::FindClip(std::uint32_t Id) const
+{
+	FHapticClipView View;
+	if (!Data)
+	{
+		return View;
+	}
+
+	const FHapticBankHeader* Header = reinterpret_cast<const FHapticBankHeader*>(Data);
+	const FHapticBankEntry* First = reinterpret_cast<const FHapticBankEntry*>(Data + Header->IndexOffset);
+	const FHapticBankEntry* Last = First + Header->ClipCount;
+	const FHapticBankEntry* Entry = std::lower_bound(First, Last, Id, [](const FHapticBankEntry& Candidate, std::uint32_t Value) {
+		return Candidate.Id < Value;
+	});
+	if (Entry == Last || Entry->Id != Id)
+	{
+		return View;
+	}
+
+	View.Pcm = std::span<const float>(reinterpret_cast<const float*>(Data + Entry->PcmOffset), static_cast<std::size_t>(Entry->Frames) * 2);
+	View.Packets = std::span<const std::uint8_t>(Data + Entry->PacketOffset, static_cast<std::size_t>(Entry->PacketCount) * PacketSize);
+	View.SampleRate = Header->SampleRate;
+	return View;
+}
+
+bool FGamepadHapticBank::Validate() const
+{
+	if (Size < sizeof(FHapticBankHeader))
+	{
+		return false;
+	}
+
+	const FHapticBankHeader* Header = reinterpret_cast<const FHapticBankHeader*>(Data);
+	if (Header->Magic != Magic || Header->Version != Version || Header->SampleRate == 0)
+	{
+		return false;
+	}
+
+	const std::uint64_t IndexBytes = static_cast<std::uint64_t>(Header->ClipCount) * sizeof(FHapticBankEntry);
+	if (Header->IndexOffset % alignof(FHapticBankEntry) != 0 || Header->IndexOffset > Size || IndexBytes > Size - Header->IndexOffset)
+	{
+		return false;
+	}
+
+	// Check every payload once here so lookups can trust the index.
+	const FHapticBankEntry* Entries = reinterpret_cast<const FHapticBankEntry*>(Data + Header->IndexOffset);
+	for (std::uint32_t Index = 0; Index < Header->ClipCount; ++Index)
+	{
+		const FHapticBankEntry& Entry = Entries[Index];
+		if (Index > 0 && Entries[Index - 1].Id >= Entry.Id)
+		{
+			return false;
+		}
+
+		const std::uint64_t PcmBytes = static_cast<std::uint64_t>(Entry.Frames) * 2 * sizeof(float);
+		const std::uint64_t PacketBytes = static_cast<std::uint64_t>(Entry.PacketCount) * PacketSize;
+		if (Entry.PcmOffset % alignof(float) != 0 || Entry.PcmOffset > Size || PcmBytes > Size - Entry.PcmOffset)
+		{
+			return false;
+		}
+		if (Entry.PacketOffset > Size || PacketBytes > Size - Entry.PacketOffset)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,199 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+
+#include "GImplementations/Utils/GamepadLinkScheduler.h"
+#include <algorithm>
+#include <cstring>
+
+bool FGamepadLinkScheduler::Start(IGamepadLinkSink* InSink, const FBluetoothLinkConfig& InConfig)
+{
+#if defined(GAMEPAD_CORE_EMBEDDED)
+	(void)InSink;
+	(void)InConfig;
+	return false;
+#else
+	if (!InSink || bRunning.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	Config = InConfig;
+	if (!Packets.Initialize(std::max<std::uint32_t>(Config.MaxQueuedPackets, 1), PacketSize))
+	{
+		return false;
+	}
+
+	Sink = InSink;
+	SentPackets = 0;
+	DroppedPackets = 0;
+	LatePackets = 0;
+	EmptySlots = 0;
+	SentOutputReports = 0;
+	DeferredOutputReports = 0;
+	MaxSlotDelayUs = 0;
+	LastOutputUs = 0;
+	StartUs = gc_time::now_us();
+	bRunning.store(true, std::memory_order_release);
+	Thread = std::thread(&FGamepadLinkScheduler::Run, this);
+	return true;
+#endif
+}
+
+void FGamepadLinkScheduler::Stop()
+{
+	bRunning.store(false, std::memory_order_seq_cst);
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	if (Thread.joinable())
+	{
+		Thread.join();
+	}
+
+	// A producer that saw the scheduler running may still be writing a
+	// packet; the queue is released once it is done.
+	while (ActiveProducers.load(std::memory_order_seq_cst) != 0)
+	{
+		std::this_thread::yield();
+	}
+#endif
+	Packets.Release();
+}
+
+bool FGamepadLinkScheduler::QueueHapticPacket(std::span<const std::uint8_t, 64> Packet)
+{
+	// Announced before checking bRunning, so Stop either sees this producer
+	// or this producer sees the scheduler stopped.
+	ActiveProducers.fetch_add(1, std::memory_order_seq_cst);
+	std::uint8_t* Block = bRunning.load(std::memory_order_seq_cst) ? Packets.AcquireWrite() : nullptr;
+	if (!Block)
+	{
+		ActiveProducers.fetch_sub(1, std::memory_order_release);
+		DroppedPackets.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	std::memcpy(Block, Packet.data(), PacketSize);
+	Packets.CommitWrite(PacketSize);
+	ActiveProducers.fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+FBluetoothLinkStats FGamepadLinkScheduler::GetStats() const
+{
+	FBluetoothLinkStats Stats;
+	Stats.SentPackets = SentPackets.load(std::memory_order_relaxed);
+	Stats.DroppedPackets = DroppedPackets.load(std::memory_order_relaxed);
+	Stats.LatePackets = LatePackets.load(std::memory_order_relaxed);
+	Stats.EmptySlots = EmptySlots.load(std::memory_order_relaxed);
+	Stats.SentOutputReports = SentOutputReports.load(std::memory_order_relaxed);
+	Stats.DeferredOutputReports = DeferredOutputReports.load(std::memory_order_relaxed);
+	Stats.MaxSlotDelayUs = MaxSlotDelayUs.load(std::memory_order_relaxed);
+	return Stats;
+}
+
+void FGamepadLinkScheduler::WaitUntil(std::uint64_t DeadlineUs) const
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	// Sleep while the deadline is far (the OS may oversleep by a timer tick),
+	// then spin the rest of the way.
+	for (;;)
+	{
+		const std::uint64_t NowUs = gc_time::now_us();
+		if (NowUs >= DeadlineUs || !bRunning.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		const std::uint64_t RemainingUs = DeadlineUs - NowUs;
+		if (RemainingUs > Config.SpinWindowUs)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(RemainingUs - Config.SpinWindowUs));
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+#else
+	(void)DeadlineUs;
+#endif
+}
+
+void FGamepadLinkScheduler::RaiseMax(std::uint64_t DelayUs)
+{
+	std::uint64_t Current = MaxSlotDelayUs.load(std::memory_order_relaxed);
+	while (DelayUs > Current && !MaxSlotDelayUs.compare_exchange_weak(Current, DelayUs, std::memory_order_relaxed))
+	{
+	}
+}
+
+void FGamepadLinkScheduler::SendPendingOutput(std::uint64_t NowUs)
+{
+	if (!bOutputPending.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	const std::uint64_t MinIntervalUs = 1000000 / std::max<std::uint32_t>(Config.MaxOutputReportsPerSecond, 1);
+	if (LastOutputUs != 0 && NowUs - LastOutputUs < MinIntervalUs)
+	{
+		DeferredOutputReports.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// Clear before composing: a request made while the report is being
+	// built is served in a later gap.
+	bOutputPending.store(false, std::memory_order_release);
+	Sink->SendOutputReport();
+	LastOutputUs = NowUs;
+	SentOutputReports.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FGamepadLinkScheduler::Run()
+{
+	std::uint64_t Slot = 0;
+	while (bRunning.load(std::memory_order_acquire))
+	{
+		const std::uint64_t SlotUs = SlotTimeUs(Slot);
+		WaitUntil(SlotUs);
+		if (!bRunning.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		const std::uint64_t NowUs = gc_time::now_us();
+		const std::uint64_t DelayUs = NowUs - SlotUs;
+		std::size_t Elements = 0;
+		if (const std::uint8_t* Packet = Packets.AcquireRead(Elements))
+		{
+			Sink->SendHapticPacket(std::span<const std::uint8_t, 64>(Packet, PacketSize));
+			Packets.ConsumeElements(Elements);
+			Packets.CommitRead();
+			SentPackets.fetch_add(1, std::memory_order_relaxed);
+			if (DelayUs > Config.LateThresholdUs)
+			{
+				LatePackets.fetch_add(1, std::memory_order_relaxed);
+			}
+			RaiseMax(DelayUs);
+		}
+		else
+		{
+			EmptySlots.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Output reports go halfway through the gap, away from both packets.
+		const std::uint64_t NextSlotUs = SlotTimeUs(Slot + 1);
+		WaitUntil(SlotUs + ((NextSlotUs - SlotUs) / 2));
+		SendPendingOutput(gc_time::now_us());
+
+		// After a stall, resume from the current slot instead of sending the
+		// missed ones back to back.
+		++Slot;
+		const std::uint64_t AfterUs = gc_time::now_us();
+		if (AfterUs > SlotTimeUs(Slot + 1))
+		{
+			Slot = (((AfterUs - StartUs) * SlotDenominator) / SlotNumeratorUs) + 1;
+		}
+	}
+}
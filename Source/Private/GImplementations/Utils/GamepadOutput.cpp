@@ -13,7 +13,55 @@
 #include <iostream>
 #include <ostream>
 
-void FGamepadOutput::OutputDualShock(FDeviceContext* DeviceContext)
+namespace
+{
+	/**
+	 * Compares the freshly composed report against the last composed one and
+	 * keeps the copy up to date. The byte at SkipIndex is ignored by the
+	 * comparison; only the DualSense Bluetooth report passes one, its
+	 * sequence byte 40.
+	 */
+	bool UpdateLastOutputReport(FDeviceContext* DeviceContext, std::size_t Length, std::size_t SkipIndex)
+	{
+		const unsigned char* Report = DeviceContext->GetRawOutputBuffer();
+		unsigned char* LastReport = DeviceContext->GetLastOutputReport();
+
+		const bool bChanged = std::memcmp(Report, LastReport, SkipIndex) != 0 ||
+		                      std::memcmp(&Report[SkipIndex + 1], &LastReport[SkipIndex + 1], Length - SkipIndex - 1) != 0;
+		if (bChanged)
+		{
+			std::memcpy(LastReport, Report, Length);
+		}
+		return bChanged;
+	}
+
+	/**
+	 * Compares the whole report, for reports without a sequence byte.
+	 */
+	bool UpdateLastOutputReport(FDeviceContext* DeviceContext, std::size_t Length)
+	{
+		const unsigned char* Report = DeviceContext->GetRawOutputBuffer();
+		unsigned char* LastReport = DeviceContext->GetLastOutputReport();
+
+		const bool bChanged = std::memcmp(Report, LastReport, Length) != 0;
+		if (bChanged)
+		{
+			std::memcpy(LastReport, Report, Length);
+		}
+		return bChanged;
+	}
+
+	void AppendBluetoothChecksum(unsigned char* MutableBuffer)
+	{
+		const auto CrcChecksum = GCoreUtils::CR32::Compute(MutableBuffer, 74);
+		MutableBuffer[0x4A] = static_cast<unsigned char>((CrcChecksum & 0x000000FF) >> 0UL);
+		MutableBuffer[0x4B] = static_cast<unsigned char>((CrcChecksum & 0x0000FF00) >> 8UL);
+		MutableBuffer[0x4C] = static_cast<unsigned char>((CrcChecksum & 0x00FF0000) >> 16UL);
+		MutableBuffer[0x4D] = static_cast<unsigned char>((CrcChecksum & 0xFF000000) >> 24UL);
+	}
+} // namespace
+
+bool FGamepadOutput::ComposeDualShock(FDeviceContext* DeviceContext)
 {
 	const FOutputContext* HidOut = &DeviceContext->Output;
 	unsigned char* MutableBuffer = DeviceContext->GetRawOutputBuffer();
@@ -36,34 +84,31 @@ void FGamepadOutput::OutputDualShock(FDeviceContext* DeviceContext)
 		MutableBuffer[11] = HidOut->FlashLigthbar.Bright_Time;
 		MutableBuffer[12] = HidOut->FlashLigthbar.Toggle_Time;
 
-		const auto CrcChecksum = GCoreUtils::CR32::Compute(MutableBuffer, 74);
-		MutableBuffer[74] = static_cast<unsigned char>((CrcChecksum & 0x000000FF) >> 0UL);
-		MutableBuffer[75] = static_cast<unsigned char>((CrcChecksum & 0x0000FF00) >> 8UL);
-		MutableBuffer[76] = static_cast<unsigned char>((CrcChecksum & 0x00FF0000) >> 16UL);
-		MutableBuffer[77] = static_cast<unsigned char>((CrcChecksum & 0xFF000000) >> 24UL);
-	}
-	else
-	{
-		// USB: Report ID 0x05, Data starts at offset 1
-		MutableBuffer[0] = 0x05;
-		MutableBuffer[1] = 0x0F; // Control mask: Rumble, Lightbar, Flash
-
-		MutableBuffer[4] = HidOut->Rumbles.Right;
-		MutableBuffer[5] = HidOut->Rumbles.Left;
-		MutableBuffer[6] = HidOut->Lightbar.R;
-		MutableBuffer[7] = HidOut->Lightbar.G;
-		MutableBuffer[8] = HidOut->Lightbar.B;
-		MutableBuffer[9] = HidOut->FlashLigthbar.Bright_Time;
-		MutableBuffer[10] = HidOut->FlashLigthbar.Toggle_Time;
+		const bool bChanged = UpdateLastOutputReport(DeviceContext, 74);
+		AppendBluetoothChecksum(MutableBuffer);
+		return bChanged;
 	}
 
-	{
-		gc_lock::lock_guard<gc_lock::mutex> LockGuard(DeviceContext->OutputMutex);
-		IPlatformHardwareInfo::Get().Write(DeviceContext);
-	}
+	// USB: Report ID 0x05, Data starts at offset 1
+	MutableBuffer[0] = 0x05;
+	MutableBuffer[1] = 0x0F; // Control mask: Rumble, Lightbar, Flash
+
+	MutableBuffer[4] = HidOut->Rumbles.Right;
+	MutableBuffer[5] = HidOut->Rumbles.Left;
+	MutableBuffer[6] = HidOut->Lightbar.R;
+	MutableBuffer[7] = HidOut->Lightbar.G;
+	MutableBuffer[8] = HidOut->Lightbar.B;
+	MutableBuffer[9] = HidOut->FlashLigthbar.Bright_Time;
+	MutableBuffer[10] = HidOut->FlashLigthbar.Toggle_Time;
+	return UpdateLastOutputReport(DeviceContext, 78);
 }
 
-void FGamepadOutput::OutputDualSense(FDeviceContext* DeviceContext)
+void FGamepadOutput::OutputDualShock(FDeviceContext* DeviceContext)
+{
+	OutputDualShock(DeviceContext, IPlatformHardwareInfo::Get());
+}
+
+bool FGamepadOutput::ComposeDualSense(FDeviceContext* DeviceContext)
 {
 	FOutputContext* HidOut = &DeviceContext->Output;
 	size_t Padding = 1;
@@ -74,56 +119,54 @@ void FGamepadOutput::OutputDualSense(FDeviceContext* DeviceContext)
 		Padding = 2;
 		MutableBuffer[0] = 0x31;
 		MutableBuffer[1] = 0x02;
-		MutableBuffer[40] ^= 0x01;
 	}
 	else
 	{
 		MutableBuffer[40] = 0x07;
 	}
 
-	{
-		gc_lock::lock_guard<gc_lock::mutex> LockGuard(DeviceContext->OutputMutex);
-
-		unsigned char* Output = &MutableBuffer[Padding];
-		Output[0] = HidOut->Feature.VibrationMode;
-		Output[1] = HidOut->Feature.FeatureMode;
-		Output[2] = HidOut->Rumbles.Right;
-		Output[3] = HidOut->Rumbles.Left;
-		Output[4] = HidOut->Audio.HeadsetVolume;
-		Output[5] = HidOut->Audio.SpeakerVolume;
-		Output[6] = HidOut->Audio.MicVolume;
-		Output[7] = HidOut->Audio.Mode;
-		Output[9] = HidOut->Audio.MicStatus == 1 ? 0x10 : 0x00;
-		Output[8] = HidOut->Audio.MicStatus == 1 ? 0x01 : 0x00;
-		Output[36] = (HidOut->Feature.TriggerSoftnessLevel << 4) | (HidOut->Feature.SoftRumbleReduce & 0x0F);
-		Output[42] = HidOut->PlayerLed.Brightness;
-		Output[43] = HidOut->PlayerLed.Led;
-		Output[44] = HidOut->Lightbar.R;
-		Output[45] = HidOut->Lightbar.G;
-		Output[46] = HidOut->Lightbar.B;
-
-		if (DeviceContext->bOverrideTriggerBytes)
-		{
-			std::memcpy(&Output[10], DeviceContext->OverrideTriggerRight, 10);
-			std::memcpy(&Output[21], DeviceContext->OverrideTriggerLeft, 10);
-		}
-		else
-		{
-			SetTriggerEffects(&Output[10], HidOut->RightTrigger);
-			SetTriggerEffects(&Output[21], HidOut->LeftTrigger);
-		}
+	unsigned char* Output = &MutableBuffer[Padding];
+	Output[0] = HidOut->Feature.VibrationMode;
+	Output[1] = HidOut->Feature.FeatureMode;
+	Output[2] = HidOut->Rumbles.Right;
+	Output[3] = HidOut->Rumbles.Left;
+	Output[4] = HidOut->Audio.HeadsetVolume;
+	Output[5] = HidOut->Audio.SpeakerVolume;
+	Output[6] = HidOut->Audio.MicVolume;
+	Output[7] = HidOut->Audio.Mode;
+	Output[9] = HidOut->Audio.MicStatus == 1 ? 0x10 : 0x00;
+	Output[8] = HidOut->Audio.MicStatus == 1 ? 0x01 : 0x00;
+	Output[36] = (HidOut->Feature.TriggerSoftnessLevel << 4) | (HidOut->Feature.SoftRumbleReduce & 0x0F);
+	Output[42] = HidOut->PlayerLed.Brightness;
+	Output[43] = HidOut->PlayerLed.Led;
+	Output[44] = HidOut->Lightbar.R;
+	Output[45] = HidOut->Lightbar.G;
+	Output[46] = HidOut->Lightbar.B;
 
-		if (DeviceContext->ConnectionType == EDSDeviceConnection::Bluetooth)
-		{
-			const auto CrcChecksum = GCoreUtils::CR32::Compute(MutableBuffer, 74);
-			MutableBuffer[0x4A] = static_cast<unsigned char>((CrcChecksum & 0x000000FF) >> 0UL);
-			MutableBuffer[0x4B] = static_cast<unsigned char>((CrcChecksum & 0x0000FF00) >> 8UL);
-			MutableBuffer[0x4C] = static_cast<unsigned char>((CrcChecksum & 0x00FF0000) >> 16UL);
-			MutableBuffer[0x4D] = static_cast<unsigned char>((CrcChecksum & 0xFF000000) >> 24UL);
-		}
+	if (DeviceContext->bOverrideTriggerBytes)
+	{
+		std::memcpy(&Output[10], DeviceContext->OverrideTriggerRight, 10);
+		std::memcpy(&Output[21], DeviceContext->OverrideTriggerLeft, 10);
+	}
+	else
+	{
+		SetTriggerEffects(&Output[10], HidOut->RightTrigger);
+		SetTriggerEffects(&Output[21], HidOut->LeftTrigger);
+	}
 
-		IPlatformHardwareInfo::Get().Write(DeviceContext);
+	if (DeviceContext->ConnectionType == EDSDeviceConnection::Bluetooth)
+	{
+		const bool bChanged = UpdateLastOutputReport(DeviceContext, 74, 40);
+		MutableBuffer[40] ^= 0x01;
+		AppendBluetoothChecksum(MutableBuffer);
+		return bChanged;
 	}
+	return UpdateLastOutputReport(DeviceContext, 78);
+}
+
+void FGamepadOutput::OutputDualSense(FDeviceContext* DeviceContext)
+{
+	OutputDualSense(DeviceContext, IPlatformHardwareInfo::Get());
 }
 
 void FGamepadOutput::SetTriggerEffects(unsigned char* Trigger, FGamepadTriggersHaptic& Effect)
@@ -246,20 +289,21 @@ void FGamepadOutput::SetTriggerEffects(unsigned char* Trigger, FGamepadTriggersH
 void FGamepadOutput::SendAudioHapticAdvanced(
     FDeviceContext* DeviceContext)
 {
-	if (!DeviceContext)
-	{
-		return;
-	}
+	SendAudioHapticAdvanced(DeviceContext, IPlatformHardwareInfo::Get());
+}
 
-	if (DeviceContext->ConnectionType == EDSDeviceConnection::Bluetooth)
+bool FGamepadOutput::ComposeAudioHaptic(FDeviceContext* DeviceContext)
+{
+	if (!DeviceContext || DeviceContext->ConnectionType != EDSDeviceConnection::Bluetooth)
 	{
-		constexpr size_t CrcOffset = 138;
-		const auto CrcChecksum = GCoreUtils::CR32::Compute(DeviceContext->BufferAudio, CrcOffset);
-		DeviceContext->BufferAudio[CrcOffset + 0] = static_cast<unsigned char>((CrcChecksum & 0x000000FF) >> 0UL);
-		DeviceContext->BufferAudio[CrcOffset + 1] = static_cast<unsigned char>((CrcChecksum & 0x0000FF00) >> 8UL);
-		DeviceContext->BufferAudio[CrcOffset + 2] = static_cast<unsigned char>((CrcChecksum & 0x00FF0000) >> 16UL);
-		DeviceContext->BufferAudio[CrcOffset + 3] = static_cast<unsigned char>((CrcChecksum & 0xFF000000) >> 24UL);
-
-		IPlatformHardwareInfo::Get().ProcessAudioHaptic(DeviceContext);
+		return false;
 	}
+
+	constexpr size_t CrcOffset = 138;
+	const auto CrcChecksum = GCoreUtils::CR32::Compute(DeviceContext->BufferAudio, CrcOffset);
+	DeviceContext->BufferAudio[CrcOffset + 0] = static_cast<unsigned char>((CrcChecksum & 0x000000FF) >> 0UL);
+	DeviceContext->BufferAudio[CrcOffset + 1] = static_cast<unsigned char>((CrcChecksum & 0x0000FF00) >> 8UL);
+	DeviceContext->BufferAudio[CrcOffset + 2] = static_cast<unsigned char>((CrcChecksum & 0x00FF0000) >> 16UL);
+	DeviceContext->BufferAudio[CrcOffset + 3] = static_cast<unsigned char>((CrcChecksum & 0xFF000000) >> 24UL);
+	return true;
 }
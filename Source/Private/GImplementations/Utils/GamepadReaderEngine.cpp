@@ -0,0 +1,410 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+
+#include "GImplementations/Utils/GamepadReaderEngine.h"
+#include <algorithm>
+
+#if !defined(GAMEPAD_CORE_EMBEDDED) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <vector>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#endif
+
+namespace
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED) && defined(__linux__)
+	/**
+	 * Level-triggered epoll set, woken through an eventfd.
+	 */
+	class FEpollReadinessBackend : public IGamepadReadinessBackend
+	{
+	public:
+		static constexpr std::uint32_t WakeKey = ~0u;
+
+		FEpollReadinessBackend()
+		    : EpollFd(epoll_create1(EPOLL_CLOEXEC))
+		    , WakeFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+		{
+			if (IsValid())
+			{
+				Add(WakeFd, WakeKey);
+			}
+		}
+
+		~FEpollReadinessBackend() override
+		{
+			if (WakeFd >= 0)
+			{
+				close(WakeFd);
+			}
+			if (EpollFd >= 0)
+			{
+				close(EpollFd);
+			}
+		}
+
+		bool IsValid() const { return EpollFd >= 0 && WakeFd >= 0; }
+
+		bool Add(std::intptr_t Descriptor, std::uint32_t Key) override
+		{
+			// The descriptor travels with the key so a hung-up one can be
+			// dropped from Wait.
+			epoll_event Event{};
+			Event.events = EPOLLIN;
+			Event.data.u64 = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(Descriptor)) << 32) | Key;
+			return epoll_ctl(EpollFd, EPOLL_CTL_ADD, static_cast<int>(Descriptor), &Event) == 0;
+		}
+
+		void Remove(std::intptr_t Descriptor) override
+		{
+			epoll_ctl(EpollFd, EPOLL_CTL_DEL, static_cast<int>(Descriptor), nullptr);
+		}
+
+		std::size_t Wait(std::uint32_t TimeoutMs, std::uint32_t* OutKeys, std::size_t MaxKeys) override
+		{
+			epoll_event Events[32];
+			const int Capacity = static_cast<int>(std::min<std::size_t>(MaxKeys, 32));
+			const int Ready = epoll_wait(EpollFd, Events, Capacity, static_cast<int>(TimeoutMs));
+
+			std::size_t Count = 0;
+			for (int Index = 0; Index < Ready; ++Index)
+			{
+				const std::uint32_t Key = static_cast<std::uint32_t>(Events[Index].data.u64);
+				if (Key == WakeKey)
+				{
+					std::uint64_t Value = 0;
+					(void)read(WakeFd, &Value, sizeof(Value));
+					continue;
+				}
+
+				// A hung-up descriptor stays ready forever; report it for a
+				// final read and stop watching it.
+				if (Events[Index].events & (EPOLLHUP | EPOLLERR))
+				{
+					const int Fd = static_cast<int>(Events[Index].data.u64 >> 32);
+					epoll_ctl(EpollFd, EPOLL_CTL_DEL, Fd, nullptr);
+				}
+				OutKeys[Count++] = Key;
+			}
+			return Count;
+		}
+
+		void Wake() override
+		{
+			const std::uint64_t Value = 1;
+			(void)write(WakeFd, &Value, sizeof(Value));
+		}
+
+	private:
+		int EpollFd = -1;
+		int WakeFd = -1;
+	};
+#endif
+
+#if !defined(GAMEPAD_CORE_EMBEDDED) && (defined(__unix__) || defined(__APPLE__))
+	/**
+	 * poll() fallback for POSIX systems without epoll, woken through a pipe.
+	 */
+	class FPollReadinessBackend : public IGamepadReadinessBackend
+	{
+	public:
+		FPollReadinessBackend()
+		{
+			if (pipe(WakePipe) == 0)
+			{
+				fcntl(WakePipe[0], F_SETFL, O_NONBLOCK);
+				fcntl(WakePipe[1], F_SETFL, O_NONBLOCK);
+			}
+		}
+
+		~FPollReadinessBackend() override
+		{
+			for (int Fd : WakePipe)
+			{
+				if (Fd >= 0)
+				{
+					close(Fd);
+				}
+			}
+		}
+
+		bool IsValid() const { return WakePipe[0] >= 0; }
+
+		bool Add(std::intptr_t Descriptor, std::uint32_t Key) override
+		{
+			gc_lock::lock_guard<gc_lock::mutex> Lock(Mutex);
+			Entries.push_back({static_cast<int>(Descriptor), Key});
+			return true;
+		}
+
+		void Remove(std::intptr_t Descriptor) override
+		{
+			gc_lock::lock_guard<gc_lock::mutex> Lock(Mutex);
+			std::erase_if(Entries, [Descriptor](const FEntry& Entry) {
+				return Entry.Fd == static_cast<int>(Descriptor);
+			});
+		}
+
+		std::size_t Wait(std::uint32_t TimeoutMs, std::uint32_t* OutKeys, std::size_t MaxKeys) override
+		{
+			{
+				gc_lock::lock_guard<gc_lock::mutex> Lock(Mutex);
+				Polled.clear();
+				Keys.clear();
+				Polled.push_back({WakePipe[0], POLLIN, 0});
+				for (const FEntry& Entry : Entries)
+				{
+					Polled.push_back({Entry.Fd, POLLIN, 0});
+					Keys.push_back(Entry.Key);
+				}
+			}
+
+			if (poll(Polled.data(), static_cast<nfds_t>(Polled.size()), static_cast<int>(TimeoutMs)) <= 0)
+			{
+				return 0;
+			}
+
+			if (Polled[0].revents & POLLIN)
+			{
+				char Drain[64];
+				while (read(WakePipe[0], Drain, sizeof(Drain)) > 0)
+				{
+				}
+			}
+
+			std::size_t Count = 0;
+			for (std::size_t Index = 1; Index < Polled.size() && Count < MaxKeys; ++Index)
+			{
+				if (Polled[Index].revents & (POLLIN | POLLHUP | POLLERR))
+				{
+					OutKeys[Count++] = Keys[Index - 1];
+				}
+
+				// Like the epoll backend: a hung-up descriptor gets one final read.
+				if (Polled[Index].revents & (POLLHUP | POLLERR | POLLNVAL))
+				{
+					Remove(Polled[Index].fd);
+				}
+			}
+			return Count;
+		}
+
+		void Wake() override
+		{
+			const char Byte = 1;
+			(void)write(WakePipe[1], &Byte, 1);
+		}
+
+	private:
+		struct FEntry
+		{
+			int Fd;
+			std::uint32_t Key;
+		};
+
+		gc_lock::mutex Mutex;
+		std::vector<FEntry> Entries;
+		std::vector<pollfd> Polled;
+		std::vector<std::uint32_t> Keys;
+		int WakePipe[2] = {-1, -1};
+	};
+#endif
+} // namespace
+
+std::unique_ptr<IGamepadReadinessBackend> IGamepadReadinessBackend::CreateDefault()
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED) && defined(__linux__)
+	auto Backend = std::make_unique<FEpollReadinessBackend>();
+	if (Backend->IsValid())
+	{
+		return Backend;
+	}
+#endif
+#if !defined(GAMEPAD_CORE_EMBEDDED) && (defined(__unix__) || defined(__APPLE__))
+	auto Fallback = std::make_unique<FPollReadinessBackend>();
+	if (Fallback->IsValid())
+	{
+		return Fallback;
+	}
+#endif
+	return nullptr;
+}
+
+FGamepadReaderEngine& FGamepadReaderEngine::Get()
+{
+	static FGamepadReaderEngine Engine;
+	return Engine;
+}
+
+FGamepadReaderEngine::~FGamepadReaderEngine()
+{
+	Stop();
+}
+
+bool FGamepadReaderEngine::Start(std::unique_ptr<IGamepadReadinessBackend> InBackend)
+{
+#if defined(GAMEPAD_CORE_EMBEDDED)
+	(void)InBackend;
+	return false;
+#else
+	if (bRunning.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	Backend = InBackend ? std::move(InBackend) : IGamepadReadinessBackend::CreateDefault();
+	if (!Backend)
+	{
+		return false;
+	}
+
+	bRunning.store(true, std::memory_order_release);
+	Thread = std::thread(&FGamepadReaderEngine::Run, this);
+	return true;
+#endif
+}
+
+void FGamepadReaderEngine::Stop()
+{
+	if (!bRunning.exchange(false, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	Backend->Wake();
+	if (Thread.joinable())
+	{
+		Thread.join();
+	}
+#endif
+
+	for (std::atomic<ISonyGamepad*>& Slot : Sources)
+	{
+		Slot.store(nullptr, std::memory_order_release);
+	}
+	Backend.reset();
+}
+
+bool FGamepadReaderEngine::AddSource(ISonyGamepad* Source, std::intptr_t Descriptor)
+{
+	if (!Source || !IsRunning() || Descriptor < 0)
+	{
+		return false;
+	}
+
+	for (const std::atomic<ISonyGamepad*>& Slot : Sources)
+	{
+		if (Slot.load(std::memory_order_acquire) == Source)
+		{
+			return false;
+		}
+	}
+
+	for (std::size_t Index = 0; Index < MaxSources; ++Index)
+	{
+		ISonyGamepad* Expected = nullptr;
+		if (Sources[Index].compare_exchange_strong(Expected, Source, std::memory_order_acq_rel))
+		{
+			Descriptors[Index] = Descriptor;
+			if (!Backend->Add(Descriptor, static_cast<std::uint32_t>(Index)))
+			{
+				Sources[Index].store(nullptr, std::memory_order_release);
+				return false;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void FGamepadReaderEngine::RemoveSource(ISonyGamepad* Source)
+{
+	if (!Source)
+	{
+		return;
+	}
+
+	bool bRemoved = false;
+	for (std::size_t Index = 0; Index < MaxSources; ++Index)
+	{
+		ISonyGamepad* Expected = Source;
+		if (Sources[Index].compare_exchange_strong(Expected, nullptr))
+		{
+			if (Backend)
+			{
+				Backend->Remove(Descriptors[Index]);
+			}
+			bRemoved = true;
+		}
+	}
+
+	if (bRemoved)
+	{
+		WaitForPass();
+	}
+}
+
+void FGamepadReaderEngine::WaitForPass()
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	// Only a pass that started before the slot was cleared can still hold
+	// the source; later passes no longer see it.
+	if (Thread.get_id() == std::this_thread::get_id())
+	{
+		return;
+	}
+
+	const std::uint64_t Sequence = PassSequence.load();
+	if ((Sequence & 1) == 0)
+	{
+		return;
+	}
+
+	while (PassSequence.load(std::memory_order_acquire) == Sequence)
+	{
+		std::this_thread::yield();
+	}
+#endif
+}
+
+void FGamepadReaderEngine::Tick(std::uint32_t TimeoutMs)
+{
+	if (!Backend)
+	{
+		return;
+	}
+
+	std::uint32_t Keys[MaxSources];
+	const std::size_t Ready = Backend->Wait(TimeoutMs, Keys, MaxSources);
+
+	PassSequence.fetch_add(1);
+	for (std::size_t Index = 0; Index < Ready; ++Index)
+	{
+		if (Keys[Index] >= MaxSources)
+		{
+			continue;
+		}
+
+		if (ISonyGamepad* Source = Sources[Keys[Index]].load())
+		{
+			Source->UpdateInput(0.0f);
+		}
+	}
+	PassSequence.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void FGamepadReaderEngine::Run()
+{
+	while (bRunning.load(std::memory_order_acquire))
+	{
+		Tick(WaitTimeoutMs);
+	}
+}
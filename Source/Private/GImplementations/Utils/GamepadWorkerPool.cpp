@@ -0,0 +1,150 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+
+#include "GImplementations/Utils/GamepadWorkerPool.h"
+#include <algorithm>
+
+bool FGamepadWorkerPool::Start(std::size_t InWorkers)
+{
+#if defined(GAMEPAD_CORE_EMBEDDED)
+	(void)InWorkers;
+	return false;
+#else
+	if (bRunning.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	if (InWorkers == 0)
+	{
+		const unsigned int Hardware = std::thread::hardware_concurrency();
+		InWorkers = Hardware > 1 ? Hardware - 1 : 0;
+	}
+	WorkerCount = std::min(InWorkers, MaxWorkers);
+	if (WorkerCount == 0)
+	{
+		return false;
+	}
+
+	// Workers start from the current generation, so a job released before
+	// they first wait is not missed.
+	bRunning.store(true, std::memory_order_release);
+	const std::uint64_t Current = Generation.load(std::memory_order_acquire);
+	for (std::size_t Index = 0; Index < WorkerCount; ++Index)
+	{
+		Workers[Index] = std::thread(&FGamepadWorkerPool::WorkerLoop, this, Index + 1, Current);
+	}
+	return true;
+#endif
+}
+
+void FGamepadWorkerPool::Stop()
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	if (!bRunning.exchange(false, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+	Generation.fetch_add(1, std::memory_order_acq_rel);
+	Generation.notify_all();
+	for (std::size_t Index = 0; Index < WorkerCount; ++Index)
+	{
+		if (Workers[Index].joinable())
+		{
+			Workers[Index].join();
+		}
+	}
+#endif
+	WorkerCount = 0;
+}
+
+void FGamepadWorkerPool::Run(std::size_t Count, void* Context, FJobFunction Function)
+{
+	if (Count == 0)
+	{
+		return;
+	}
+
+	// A single item or no worker: not worth waking anyone.
+	if (WorkerCount == 0 || Count == 1)
+	{
+		for (std::size_t Index = 0; Index < Count; ++Index)
+		{
+			Function(Context, Index);
+		}
+		return;
+	}
+
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	const std::size_t Participants = std::min(Count, WorkerCount + 1);
+	const std::size_t Base = Count / Participants;
+	const std::size_t Extra = Count % Participants;
+	std::size_t Begin = 0;
+	for (std::size_t Participant = 0; Participant <= WorkerCount; ++Participant)
+	{
+		const std::size_t Size = Participant < Participants ? Base + (Participant < Extra ? 1 : 0) : 0;
+		Shares[Participant].Next.store(Begin, std::memory_order_relaxed);
+		Shares[Participant].End = Begin + Size;
+		Begin += Size;
+	}
+
+	JobContext = Context;
+	JobFunction = Function;
+	Busy.store(WorkerCount, std::memory_order_relaxed);
+	Generation.fetch_add(1, std::memory_order_release);
+	Generation.notify_all();
+
+	Work(0);
+
+	for (std::size_t Remaining = Busy.load(std::memory_order_acquire); Remaining != 0; Remaining = Busy.load(std::memory_order_acquire))
+	{
+		Busy.wait(Remaining, std::memory_order_acquire);
+	}
+#endif
+}
+
+void FGamepadWorkerPool::Work(std::size_t Participant)
+{
+	// Own share first, then steal from the others in turn.
+	const std::size_t Count = WorkerCount + 1;
+	for (std::size_t Offset = 0; Offset < Count; ++Offset)
+	{
+		FShare& Share = Shares[(Participant + Offset) % Count];
+		for (;;)
+		{
+			const std::size_t Index = Share.Next.fetch_add(1, std::memory_order_relaxed);
+			if (Index >= Share.End)
+			{
+				break;
+			}
+			JobFunction(JobContext, Index);
+		}
+	}
+}
+
+void FGamepadWorkerPool::WorkerLoop(std::size_t Participant, std::uint64_t Seen)
+{
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	for (;;)
+	{
+		Generation.wait(Seen, std::memory_order_acquire);
+		Seen = Generation.load(std::memory_order_acquire);
+		if (!bRunning.load(std::memory_order_acquire))
+		{
+			return;
+		}
+
+		Work(Participant);
+		if (Busy.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			Busy.notify_one();
+		}
+	}
+#else
+	(void)Participant;
+	(void)Seen;
+#endif
+}
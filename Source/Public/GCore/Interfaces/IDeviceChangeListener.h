@@ -0,0 +1,27 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "../Types/ECoreGamepad.h"
+#include <string>
+
+/**
+ * Receives device arrival and removal notifications from a platform that can
+ * watch the bus (udev monitor, WM_DEVICECHANGE, IOKit notifications).
+ *
+ * Notifications may come from any thread, so implementations must only record
+ * them and act later on their own thread.
+ */
+class IDeviceChangeListener
+{
+public:
+	virtual ~IDeviceChangeListener() = default;
+	/**
+	 * Called when a device appears or disappears.
+	 *
+	 * @param Change Whether the device arrived or was removed.
+	 * @param Path The platform path of the device, or empty if unknown.
+	 */
+	virtual void OnDeviceChanged(EDSDeviceChange Change, const std::string& Path) = 0;
+};
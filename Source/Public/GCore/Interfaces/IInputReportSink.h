@@ -0,0 +1,28 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+
+struct FDeviceContext;
+
+/**
+ * Receives the input reports drained by IPlatformHardwareInfo::ReadAll, one
+ * at a time and oldest first.
+ *
+ * Called on the thread reading the device, without any lock of the platform
+ * held, so the sink may write to the device.
+ */
+class IInputReportSink
+{
+public:
+	virtual ~IInputReportSink() = default;
+	/**
+	 * Called with one report in the input buffer of the context (BufferDS4
+	 * for a DualShock 4 over Bluetooth, Buffer otherwise). The next report
+	 * overwrites it.
+	 *
+	 * @param Context The device the report was read from.
+	 */
+	virtual void OnInputReport(FDeviceContext* Context) = 0;
+};
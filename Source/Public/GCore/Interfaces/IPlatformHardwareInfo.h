@@ -7,6 +7,8 @@
 
 #include "../Types/DSCoreTypes.h"
 #include "../Types/Structs/Context/DeviceContext.h"
+#include "IDeviceChangeListener.h"
+#include "IInputReportSink.h"
 
 #define SONY_ (PLATFORM_PS4 || PLATFORM_PS5)
 
@@ -81,6 +83,24 @@ public:
 	 * information or state required to perform the read operation.
 	 */
 	virtual void Read(FDeviceContext* Context) = 0;
+	/**
+	 * Reads every input report queued for a device, not only the newest.
+	 *
+	 * Each report is placed in the input buffer of the context and handed to
+	 * Sink, oldest first; the newest one is left in the buffer, as after
+	 * Read. The default implementation reads once, for platforms that only
+	 * keep the latest report.
+	 *
+	 * @param Context The device to read.
+	 * @param Sink Receives every report read.
+	 * @return The number of reports handed to Sink.
+	 */
+	virtual std::size_t ReadAll(FDeviceContext* Context, IInputReportSink* Sink)
+	{
+		Read(Context);
+		Sink->OnInputReport(Context);
+		return 1;
+	}
 	/**
 	 * Writes data to the hardware device using the provided context.
 	 *
@@ -92,6 +112,23 @@ public:
 	 * information or state required to perform the write operation.
 	 */
 	virtual void Write(FDeviceContext* Context) = 0;
+	/**
+	 * Writes the already composed output reports of several devices at once.
+	 *
+	 * Platforms able to submit many reports with a single kernel transition
+	 * (io_uring, overlapped I/O, ...) override this method. The default
+	 * implementation simply writes each context in order.
+	 *
+	 * @param Contexts The device contexts whose output buffers must be sent.
+	 * The caller holds the OutputMutex of every context for the whole call.
+	 */
+	virtual void WriteBatch(std::span<FDeviceContext*> Contexts)
+	{
+		for (FDeviceContext* Context : Contexts)
+		{
+			Write(Context);
+		}
+	}
 	/**
 	 * Detects and collects information about connected hardware devices.
 	 *
@@ -105,6 +142,20 @@ public:
 	 * details.
 	 */
 	virtual void Detect(std::vector<FDeviceContext>& Devices) = 0;
+	/**
+	 * Starts or stops reporting device arrival and removal as they happen.
+	 *
+	 * Platforms without a notification mechanism keep the default, which
+	 * returns false; callers then rely on periodic Detect calls.
+	 *
+	 * @param Listener Receives the notifications, or nullptr to stop watching.
+	 * @return True if the platform watches devices for this listener.
+	 */
+	virtual bool WatchDevices(IDeviceChangeListener* Listener)
+	{
+		(void)Listener;
+		return false;
+	}
 	/**
 	 * Initializes and creates a handle for the specified device context.
 	 *
@@ -132,6 +183,21 @@ public:
 	 * relevant device information required for this operation.
 	 */
 	virtual void InvalidateHandle(FDeviceContext* Context) = 0;
+	/**
+	 * Returns the OS descriptor a readiness multiplexer can wait on for input
+	 * reports of a device (a file descriptor on POSIX).
+	 *
+	 * Platforms whose handles cannot be multiplexed keep the default, which
+	 * returns -1; their devices are read with blocking Read calls.
+	 *
+	 * @param Context The device context whose handle was created.
+	 * @return The descriptor, or -1 if none is available.
+	 */
+	virtual std::intptr_t GetPollDescriptor(FDeviceContext* Context)
+	{
+		(void)Context;
+		return -1;
+	}
 	/**
 	 * Processes audio haptic feedback for the given device context.
 	 *
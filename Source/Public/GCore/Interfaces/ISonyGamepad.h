@@ -67,10 +67,45 @@ public:
 	 * correctly synchronized with the device hardware.
 	 */
 	virtual void UpdateOutput() = 0;
+	/**
+	 * Builds the next output report into the device buffer without writing it.
+	 *
+	 * Used by the device registry to batch the output of every connected
+	 * gamepad into a single IPlatformHardwareInfo::WriteBatch call. The caller
+	 * must hold the OutputMutex of the device context.
+	 *
+	 * @return True if the composed report differs from the last one and has to
+	 * be sent to the device.
+	 */
+	virtual bool PrepareOutput() { return false; }
+	/**
+	 * Advances the staged initialization started by Initialize.
+	 *
+	 * Initialize never blocks: devices that need time between setup reports
+	 * (e.g. DualSense over Bluetooth) report a pending state and are moved
+	 * forward by this call, from the registry tick or the output path.
+	 *
+	 * @return True once the gamepad is ready for regular output.
+	 */
+	virtual bool AdvanceInitialization() { return true; }
+	/**
+	 * @return True if the gamepad finished its initialization.
+	 */
+	virtual bool IsReady() const { return true; }
 	/**
 	 * Updates the input state for the Sony gamepad interface.
 	 */
 	virtual void UpdateInput(float Delta) = 0;
+	/**
+	 * Makes UpdateInput drain every report queued since the previous call.
+	 *
+	 * The older reports only feed edge events and the motion average; the
+	 * newest one is decoded and published, so a consumer updating slower
+	 * than the controller reports never falls behind.
+	 *
+	 * @param bDrain True to drain, false to read one report per call.
+	 */
+	virtual void EnableInputDrain(bool bDrain) { (void)bDrain; }
 	/**
 	 * Configures various settings for the Sony gamepad, including audio, lightbar,
 	 * and rumble features. Allows customization of multiple gamepad functionalities
@@ -4,6 +4,12 @@
 // Targets: Windows, Linux, macOS.
 #pragma once
 #include "../../Types/DSCoreTypes.h"
+#include "../../Types/Structs/Config/BluetoothLink.h"
+#include "../../Types/Structs/Config/HapticsDsp.h"
+#include "../../Types/Structs/Config/HapticsLatency.h"
+
+class FGamepadHapticsMixer;
+struct FHapticClipView;
 
 /**
  *
@@ -38,4 +44,159 @@ public:
 	 *                  feedback effects.
 	 */
 	virtual void AudioHapticUpdate(const std::vector<std::int16_t>& AudioData) = 0;
+	/**
+	 * Allocation-free variant of the Bluetooth haptic update.
+	 *
+	 * @param AudioData Exactly 64 bytes of 8-bit haptic samples, as sent in a
+	 *                  single Bluetooth audio report. The extent is checked at
+	 *                  compile time.
+	 */
+	virtual void AudioHapticUpdate(std::span<const std::uint8_t, 64> AudioData) = 0;
+	/**
+	 * Allocation-free variant of the USB haptic update.
+	 *
+	 * @param AudioData Interleaved stereo 16-bit samples (left, right). Any view
+	 *                  over contiguous memory can be passed, such as a stack
+	 *                  array or a region of a ring buffer.
+	 */
+	virtual void AudioHapticUpdate(std::span<const std::int16_t> AudioData) = 0;
+	/**
+	 * Float variant of the USB haptic update, for engines that already mix in
+	 * float and want to skip the conversion to int16.
+	 *
+	 * @param AudioData Interleaved stereo float samples (left, right) in the
+	 *                  [-1, 1] range.
+	 */
+	virtual void AudioHapticUpdate(std::span<const float> AudioData) = 0;
+	/**
+	 * Streams speaker/headset PCM to channels 0/1 of the USB audio device.
+	 * The samples are interleaved with the haptics in the same device blocks,
+	 * so they play in sync with the haptics queued after them.
+	 *
+	 * @param AudioData Interleaved stereo 16-bit samples (left, right).
+	 */
+	virtual void AudioSpeakerUpdate(std::span<const std::int16_t> AudioData) = 0;
+	/**
+	 * Float variant of the speaker/headset stream.
+	 *
+	 * @param AudioData Interleaved stereo float samples (left, right) in the
+	 *                  [-1, 1] range.
+	 */
+	virtual void AudioSpeakerUpdate(std::span<const float> AudioData) = 0;
+	/**
+	 * Sets the digital gains of the speaker and haptic streams of the USB
+	 * audio device. The hardware volume is set with the audio settings.
+	 *
+	 * @param SpeakerGain Gain of the speaker/headset stream.
+	 * @param HapticsGain Gain of the haptic stream.
+	 */
+	virtual void SetAudioStreamGains(float SpeakerGain, float HapticsGain) = 0;
+	/**
+	 * Sets the sample rate of the PCM passed to the int16 and float
+	 * AudioHapticUpdate overloads. Over Bluetooth the PCM is resampled to the
+	 * controller haptic rate by the library.
+	 *
+	 * @param SampleRate The PCM sample rate in Hz (48000 by default).
+	 */
+	virtual void SetHapticsSampleRate(std::uint32_t SampleRate) = 0;
+	/**
+	 * Configures the audio-to-haptics processing applied to the int16 and
+	 * float AudioHapticUpdate overloads before they reach the USB queue or
+	 * the Bluetooth encoder. May be called from any thread; the settings
+	 * are applied at the start of the next haptics block.
+	 *
+	 * @param Config The processing settings; disabled settings pass the PCM
+	 *               through untouched.
+	 */
+	virtual void SetHapticsDsp(const FHapticsDspConfig& Config) = 0;
+	/**
+	 * Configures the target and maximum latency of the USB haptics stream.
+	 *
+	 * @param Latency The latency settings. The target applies immediately, the
+	 *                capacity and period on the next audio device initialization.
+	 */
+	virtual void SetHapticsLatency(const FHapticsLatencyConfig& Latency) = 0;
+	/**
+	 * Reads the fill level and the underrun/overrun counters of the USB
+	 * haptics stream.
+	 *
+	 * @param OutStats Receives the telemetry snapshot.
+	 * @return False if no audio device is active for this gamepad.
+	 */
+	virtual bool GetHapticsStats(FHapticsBufferStats& OutStats) = 0;
+	/**
+	 * Provides the per-controller mixer used to layer haptic voices (streams
+	 * and one-shot clips) with priorities and ducking.
+	 *
+	 * @return The mixer of this gamepad.
+	 */
+	virtual FGamepadHapticsMixer* GetHapticsMixer() = 0;
+	/**
+	 * Renders the haptics mixer and queues the result like AudioHapticUpdate.
+	 * Intended to be called from the audio thread.
+	 *
+	 * @param Frames The number of frames to render at the haptics sample rate.
+	 *               Zero renders what the USB haptics queue needs to reach its
+	 *               latency target.
+	 */
+	virtual void RenderHapticsMixer(std::uint32_t Frames) = 0;
+	/**
+	 * Plays a clip of a compiled haptic bank once, straight from the bank
+	 * mapping. Over USB the PCM is played by a mixer voice; over Bluetooth the
+	 * pre-encoded packets are sent as RenderHapticsMixer advances, replacing
+	 * the mixer output until the clip ends.
+	 *
+	 * @param Clip The clip; the bank must stay open until it has played.
+	 * @param Priority Mixer priority of the clip (USB).
+	 * @param Gain Mixer gain of the clip (USB).
+	 * @return False if the clip has no payload for the connection, no voice
+	 * is free, or, over USB, the bank was compiled for another rate than the
+	 * one set with SetHapticsSampleRate.
+	 */
+	virtual bool PlayHapticClip(const FHapticClipView& Clip, std::uint8_t Priority, float Gain) = 0;
+	/**
+	 * Plays a clip through the haptics mixer so that its first frame reaches
+	 * the actuators at a given host time. Over USB the time is converted with
+	 * the audio device clock and the frames queued ahead; over Bluetooth the
+	 * mixer output is sent as it is rendered.
+	 *
+	 * Accurate as long as the mixer is the only producer of the haptics queue.
+	 *
+	 * @param Interleaved Interleaved stereo floats at the haptics sample rate,
+	 *                    kept valid until the clip has played.
+	 * @param HostTimeUs Target time on the gc_time::now_us clock; past times
+	 *                   start immediately.
+	 * @return The mixer voice, or -1 if no voice is free.
+	 */
+	virtual std::int32_t ScheduleHapticClip(std::span<const float> Interleaved, std::uint64_t HostTimeUs, std::uint8_t Priority, float Gain) = 0;
+	/**
+	 * Creates a mixer stream voice whose first frame reaches the actuators at
+	 * a given host time; samples pushed earlier wait for it.
+	 *
+	 * @param HostTimeUs Target time on the gc_time::now_us clock.
+	 * @return The mixer voice, or -1 if no voice is free.
+	 */
+	virtual std::int32_t ScheduleHapticStream(std::uint64_t HostTimeUs, std::uint8_t Priority, float Gain) = 0;
+	/**
+	 * Starts the Bluetooth link scheduler of this gamepad. While it runs,
+	 * haptic packets are queued and sent on the controller haptic cadence,
+	 * and output updates are coalesced into reports sent between packets.
+	 *
+	 * @param Config Queue depth, output report budget and timing settings.
+	 * @return False if the gamepad is not connected over Bluetooth or the
+	 * scheduler cannot start.
+	 */
+	virtual bool EnableBluetoothLink(const FBluetoothLinkConfig& Config) = 0;
+	/**
+	 * Stops the Bluetooth link scheduler; haptics and output reports are sent
+	 * directly again.
+	 */
+	virtual void DisableBluetoothLink() = 0;
+	/**
+	 * Reads the counters of the Bluetooth link scheduler.
+	 *
+	 * @param OutStats Receives the counters.
+	 * @return False if the scheduler is not running.
+	 */
+	virtual bool GetBluetoothLinkStats(FBluetoothLinkStats& OutStats) = 0;
 };
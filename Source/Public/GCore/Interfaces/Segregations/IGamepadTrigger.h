@@ -5,6 +5,7 @@
 #pragma once
 #include "../../Types/DSCoreTypes.h"
 #include "GCore/Types/ECoreGamepad.h"
+#include "GCore/Types/Structs/Config/GamepadTriggerKeyframe.h"
 
 /**
  *
@@ -53,6 +54,18 @@ public:
 	 */
 	virtual void SetCustomTrigger(const EDSGamepadHand& Hand,
 	                              const std::vector<std::uint8_t>& HexBytes) = 0;
+	/**
+	 * Activates custom trigger configurations from a fixed block of 10 bytes.
+	 *
+	 * Allocation-free variant of SetCustomTrigger: accepts stack arrays,
+	 * ring-buffer regions or mapped memory, and the size is checked at compile
+	 * time.
+	 *
+	 * @param Hand The hand (left, right or both) whose trigger is configured.
+	 * @param HexBytes The 10 raw bytes of the trigger effect, mode byte first.
+	 */
+	virtual void SetCustomTrigger(const EDSGamepadHand& Hand,
+	                              std::span<const std::uint8_t, 10> HexBytes) = 0;
 	/**
 	 * Configures the bow tension effect on the gamepad triggers based on
 	 * specified parameters.
@@ -129,4 +142,33 @@ public:
 	                          std::uint8_t Force, std::uint8_t Amplitude,
 	                          std::uint8_t Period, std::uint8_t Frequency,
 	                          const EDSGamepadHand& Hand) = 0;
+	/**
+	 * Plays a timed sequence of trigger effects on the specified hand.
+	 *
+	 * The sequence runs on the library clock and is evaluated every time the
+	 * output report is built, so the effect timing follows the output tick
+	 * instead of the game frame. Calling any other trigger setter for the same
+	 * hand stops the sequence.
+	 *
+	 * @param Hand The controller hand (left, right or both) that plays the
+	 * sequence.
+	 * @param Keyframes The timed keyframes of the sequence.
+	 * @param bLoop Whether the sequence restarts after its last keyframe.
+	 */
+	virtual void PlayTriggerSequence(const EDSGamepadHand& Hand,
+	                                 const std::vector<FGamepadTriggerKeyframe>& Keyframes,
+	                                 bool bLoop) = 0;
+	/**
+	 * Stops a trigger sequence. The last evaluated effect stays applied.
+	 *
+	 * @param Hand The controller hand whose sequence should be stopped.
+	 */
+	virtual void StopTriggerSequence(const EDSGamepadHand& Hand) = 0;
+	/**
+	 * Checks whether a trigger sequence is playing on the specified hand.
+	 *
+	 * @param Hand The controller hand to check. AnyHand checks both triggers.
+	 * @return True if a sequence is still playing.
+	 */
+	virtual bool IsTriggerSequencePlaying(const EDSGamepadHand& Hand) = 0;
 };
@@ -2,12 +2,25 @@
 // Created for: GamepadCore - Plugin to support DualSense controller on Windows.
 // Planned Release Year: 2025
 #pragma once
+#include "GCore/Interfaces/IDeviceChangeListener.h"
 #include "GCore/Interfaces/IDeviceRegistry.h"
 #include "GCore/Interfaces/IPlatformHardwareInfo.h"
+#include "GCore/Templates/TGenericHardwareInfo.h"
+#include "GCore/Templates/TSlotMap.h"
+#include "GCore/Templates/TSpscBlockQueue.h"
 #include "GCore/Types/ECoreGamepad.h"
-#include "GImplementations/Libraries/DualSense/DualSenseLibrary.h"
-#include "GImplementations/Libraries/DualShock/DualShockLibrary.h"
+#include "GImplementations/Libraries/DualSense/TDualSenseLibrary.h"
+#include "GCore/Utils/SoDefines.h"
+#include "GImplementations/Libraries/DualShock/TDualShockLibrary.h"
+#include "GImplementations/Utils/GamepadAudioEngine.h"
+#include "GImplementations/Utils/GamepadReaderEngine.h"
+#include "GImplementations/Utils/GamepadWorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <ranges>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 namespace GamepadCore
@@ -23,124 +36,1114 @@ namespace GamepadCore
 		{ t.DispatchNewGamepad(id) } -> std::same_as<void>;
 	};
 
-	template<typename DeviceRegistryPolicy>
-	class TBasicDeviceRegistry : public IDeviceRegistry
+	/**
+	 * Registry of the connected gamepads.
+	 *
+	 * With THardwarePolicy left void, the registry and its libraries reach
+	 * the hardware through the IPlatformHardwareInfo singleton. Given a
+	 * policy type, they are bound to one policy instance at compile time and
+	 * call it directly, which lets the hot paths inline its Read and Write.
+	 */
+	template<typename DeviceRegistryPolicy, typename THardwarePolicy = void>
+	    requires(std::is_void_v<THardwarePolicy> || IsHardwarePolicy<THardwarePolicy>)
+	class TBasicDeviceRegistry : public IDeviceRegistry,
+	                             private IDeviceChangeListener
 	{
 		using EngineIdType = typename DeviceRegistryPolicy::EngineIdType;
-		std::unordered_map<std::string, typename DeviceRegistryPolicy::EngineIdType> KnownDevicePaths;
+
+		static constexpr bool bStaticHardware = !std::is_void_v<THardwarePolicy>;
+		using FHardware = std::conditional_t<bStaticHardware, THardwarePolicy, IPlatformHardwareInfo>;
+		using FDualSense = std::conditional_t<bStaticHardware, TDualSenseLibrary<FHardware>, FDualSenseLibrary>;
+		using FDualShock = std::conditional_t<bStaticHardware, TDualShockLibrary<FHardware>, FDualShockLibrary>;
+
+		/**
+		 * An open device path and the detection pass that last reported it.
+		 */
+		struct FKnownDevice
+		{
+			EngineIdType DeviceId;
+			std::uint32_t SeenPass = 0;
+		};
+
+		/**
+		 * A gamepad library constructed in place, and its interface.
+		 */
+		struct FGamepadSlot
+		{
+			std::variant<std::monostate, FDualSense, FDualShock> Library;
+			ISonyGamepad* Gamepad = nullptr;
+			/** Non-owning reference count shared with the snapshots. */
+			std::shared_ptr<ISonyGamepad> Shared;
+			/** True while the reader engine reads its input. */
+			bool bReadByEngine = false;
+		};
+
+		using FSlotHandle = typename TSlotMap<FGamepadSlot>::FHandle;
+
+		/**
+		 * Paths are only looked up on hotplug; per-frame work goes through the
+		 * slot map.
+		 */
+		std::unordered_map<std::string, FKnownDevice> KnownDevicePaths;
 		std::unordered_map<std::string, typename DeviceRegistryPolicy::EngineIdType> HistoryDevices;
-		std::unordered_map<typename DeviceRegistryPolicy::EngineIdType, std::shared_ptr<ISonyGamepad>, typename DeviceRegistryPolicy::Hasher> LibraryInstances;
+		std::unordered_map<typename DeviceRegistryPolicy::EngineIdType, FSlotHandle, typename DeviceRegistryPolicy::Hasher> LibraryHandles;
+		TSlotMap<FGamepadSlot> Libraries;
+
+	public:
+		/**
+		 * Immutable list of the gamepads registered at one point in time. A
+		 * gamepad stays alive while any snapshot, or any pointer taken from
+		 * one, still references it. The registry itself must outlive them.
+		 */
+		struct FDeviceSnapshot
+		{
+			struct FEntry
+			{
+				EngineIdType DeviceId;
+				std::shared_ptr<ISonyGamepad> Gamepad;
+			};
+
+			std::vector<FEntry> Devices;
+
+			const std::shared_ptr<ISonyGamepad>* Find(const EngineIdType& DeviceId) const
+			{
+				auto It = std::ranges::find_if(Devices, [&DeviceId](const FEntry& Entry) {
+					return Entry.DeviceId == DeviceId;
+				});
+				return It != Devices.end() ? &It->Gamepad : nullptr;
+			}
+		};
+
+	private:
+		/**
+		 * Published on every change; readers on other threads load it without
+		 * going through the registry maps. See GetSnapshot for the locking
+		 * of the standard library.
+		 */
+		std::atomic<std::shared_ptr<const FDeviceSnapshot>> Snapshot;
+
+		/**
+		 * Removed gamepads still referenced by a snapshot. Shut down and
+		 * reclaimed by PlugAndPlay once the last reference is gone.
+		 */
+		struct FRetiredLibrary
+		{
+			FSlotHandle Handle;
+			std::weak_ptr<ISonyGamepad> Reference;
+		};
+		std::vector<FRetiredLibrary> RetiredLibraries;
+
+		/**
+		 * Optional engine reading the input of every gamepad from one thread.
+		 */
+		FGamepadReaderEngine* ReaderEngine = nullptr;
+
+		/**
+		 * Optional engine rendering the haptics of every gamepad from one
+		 * thread.
+		 */
+		FGamepadAudioEngine* AudioEngine = nullptr;
+
+		/**
+		 * Optional pool Tick spreads the per-gamepad work over, and its
+		 * scratch, kept between ticks so their capacity is reused.
+		 */
+		FGamepadWorkerPool* TickPool = nullptr;
+		std::vector<FGamepadSlot*> TickSlots;
+		std::vector<std::uint8_t> TickOutputs;
+
+		std::vector<FDeviceContext*> PendingOutputs;
+		std::vector<EngineIdType> PendingInitializations;
+
+		/**
+		 * Detection scratch, kept between passes so their capacity is reused.
+		 */
+		std::vector<FDeviceContext> DetectedDevices;
+		std::vector<EngineIdType> OrphanDevices;
+		std::uint32_t DetectionPass = 0;
 
 		float TimeAccumulator = 0.0f;
-		const float DetectionInterval = 1.0f;
+		std::atomic<float> DetectionInterval = 1.0f;
+
+		/**
+		 * Set by device notifications and RequestImmediateDetection; the next
+		 * detection runs without waiting for the interval.
+		 */
+		std::atomic<bool> bDetectionRequested = false;
+		bool bWatchingDevices = false;
+
+		/**
+		 * A slot reserved by the registry in which the discovery thread
+		 * constructs a library. Slot pages never move, so the pointer stays
+		 * valid while the slot map grows.
+		 */
+		struct FSlotLease
+		{
+			FSlotHandle Handle;
+			FGamepadSlot* Slot = nullptr;
+		};
+
+		/**
+		 * A discovery result handed from the background thread to the thread
+		 * calling PlugAndPlay.
+		 */
+		struct FDiscoveryEvent
+		{
+			EDSDeviceChange Change = EDSDeviceChange::Arrived;
+			std::string Path;
+			FSlotLease Lease;
+		};
+
+		static constexpr std::size_t DiscoveryQueueEvents = 64;
+		static constexpr std::size_t DiscoverySpareSlots = 4;
+		static constexpr unsigned int DiscoveryPollMs = 10;
+
+		/**
+		 * Background discovery. Events and slot leases travel through
+		 * wait-free queues; everything below them is owned by the discovery
+		 * thread while it runs.
+		 */
+		TSpscBlockQueue<FDiscoveryEvent*> DiscoveryEvents;
+		TSpscBlockQueue<FSlotLease> DiscoveryLeases;
+		std::size_t OutstandingLeases = 0;
+		std::atomic<bool> bDiscoveryRunning = false;
+		std::unordered_map<std::string, std::uint32_t> DiscoveredPaths;
+		std::vector<FSlotLease> DiscoverySpares;
+		std::vector<std::unique_ptr<FDiscoveryEvent>> DiscoveryInitializing;
+		std::vector<std::unique_ptr<FDiscoveryEvent>> DiscoveryBacklog;
+		std::vector<FDeviceContext> DiscoveryDevices;
+		std::uint32_t DiscoveryPass = 0;
+		/** Set when a detection ran out of leased slots; it resumes once leases arrive. */
+		bool bAwaitingLeases = false;
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+		std::thread DiscoveryThread;
+#endif
+
+		/**
+		 * Policy the registry is bound to; unused with the singleton.
+		 */
+		FHardware* Hardware = nullptr;
 
 	public:
 		DeviceRegistryPolicy Policy;
 
-		virtual ~TBasicDeviceRegistry() override = default;
+		TBasicDeviceRegistry()
+		    requires(!bStaticHardware)
+		= default;
+
+		/**
+		 * Binds the registry and the libraries it opens to a policy, which
+		 * must outlive them.
+		 */
+		explicit TBasicDeviceRegistry(FHardware& InHardware)
+		    requires(bStaticHardware)
+		    : Hardware(&InHardware)
+		{}
+
+		virtual ~TBasicDeviceRegistry() override
+		{
+			StopBackgroundDiscovery();
+			StopWatchingDevices();
+			SetReaderEngine(nullptr);
+			SetAudioEngine(nullptr);
+
+			// Their threads must stop before the slot pages are destroyed.
+			for (FGamepadSlot* Slot : Libraries)
+			{
+				Slot->Gamepad->ShutdownLibrary();
+			}
+			for (const FRetiredLibrary& Retired : RetiredLibraries)
+			{
+				FGamepadSlot* Slot = Libraries.FindReserved(Retired.Handle);
+				if (Slot && Slot->Gamepad)
+				{
+					Slot->Gamepad->ShutdownLibrary();
+				}
+			}
+		}
 
 		virtual void PlugAndPlay(float DeltaTime) override
 		{
+			ReclaimRetiredLibraries();
+			AdvancePendingInitializations();
+
+			if (bDiscoveryRunning.load(std::memory_order_acquire))
+			{
+				DrainDiscoveryEvents();
+				LeaseDiscoverySlots();
+				return;
+			}
+
+			const bool bRequested = bDetectionRequested.exchange(false, std::memory_order_acq_rel);
 			TimeAccumulator += DeltaTime;
-			if (TimeAccumulator < DetectionInterval)
+			if (!bRequested && TimeAccumulator < DetectionInterval.load(std::memory_order_relaxed))
 			{
 				return;
 			}
 			TimeAccumulator = 0.0f;
 
-			std::unordered_set<std::string> OrphanPaths;
-			OrphanPaths.clear();
-			for (const auto& [Path, Key] : KnownDevicePaths)
+			DetectedDevices.clear();
+			GetHardware().Detect(DetectedDevices);
+
+			// Only paths not open yet get a handle; known ones are just marked
+			// as still present.
+			const std::uint32_t Pass = ++DetectionPass;
+			for (FDeviceContext& Context : DetectedDevices)
 			{
-				OrphanPaths.insert(Path);
+				auto It = KnownDevicePaths.find(Context.Path);
+				if (It != KnownDevicePaths.end())
+				{
+					It->second.SeenPass = Pass;
+					continue;
+				}
+
+				Context.Output = FOutputContext();
+				const FSlotHandle Handle = Libraries.Reserve();
+				if (OpenLibrary(Context, *Libraries.FindReserved(Handle)))
+				{
+					AdoptLibrary(Context.Path, Handle, Pass);
+					continue;
+				}
+				Libraries.Remove(Handle);
 			}
 
-			std::vector<FDeviceContext> DetectedDevices;
-			DetectedDevices.clear();
-			IPlatformHardwareInfo::Get().Detect(DetectedDevices);
+			OrphanDevices.clear();
+			std::erase_if(KnownDevicePaths, [this, Pass](const auto& Entry) {
+				if (Entry.second.SeenPass == Pass)
+				{
+					return false;
+				}
+
+				OrphanDevices.push_back(Entry.second.DeviceId);
+				return true;
+			});
 
-			for (const auto& Context : DetectedDevices)
+			for (const EngineIdType& DeviceId : OrphanDevices)
 			{
-				OrphanPaths.erase(Context.Path);
+				RemoveLibraryInstance(DeviceId);
 			}
+		}
 
-			for (const std::string& Path : OrphanPaths)
+		/**
+		 * Looks up a gamepad from the thread that calls PlugAndPlay. Other
+		 * threads use AcquireLibrary or GetSnapshot.
+		 */
+		ISonyGamepad* GetLibrary(EngineIdType DeviceId)
+		{
+			auto It = LibraryHandles.find(DeviceId);
+			return It != LibraryHandles.end() ? GetLibrary(It->second) : nullptr;
+		}
+
+		/**
+		 * Resolves a handle from GetLibraryHandle without hashing.
+		 *
+		 * @return Nullptr once the gamepad was removed.
+		 */
+		ISonyGamepad* GetLibrary(FSlotHandle Handle) const
+		{
+			const FGamepadSlot* Slot = Libraries.Find(Handle);
+			return Slot ? Slot->Gamepad : nullptr;
+		}
+
+		/**
+		 * @return A stable handle to the gamepad of an engine device, or an
+		 * invalid one if none is connected.
+		 */
+		FSlotHandle GetLibraryHandle(EngineIdType DeviceId) const
+		{
+			auto It = LibraryHandles.find(DeviceId);
+			return It != LibraryHandles.end() ? It->second : FSlotHandle{};
+		}
+
+		/**
+		 * @return The current device list. Safe from any thread; the gamepads
+		 * it lists stay valid while it is held.
+		 *
+		 * Readers never wait on the registry maps or on PlugAndPlay, but the
+		 * load is not wait-free everywhere: libstdc++ implements
+		 * std::atomic<std::shared_ptr> with an internal lock held for the
+		 * pointer copy (is_lock_free() is false), which a concurrent
+		 * PublishSnapshot can briefly contend.
+		 */
+		std::shared_ptr<const FDeviceSnapshot> GetSnapshot() const
+		{
+			return Snapshot.load(std::memory_order_acquire);
+		}
+
+		/**
+		 * Looks up a gamepad from any thread.
+		 *
+		 * @return A reference that keeps the gamepad alive after it is
+		 * unplugged, or nullptr if none is registered for the device.
+		 */
+		std::shared_ptr<ISonyGamepad> AcquireLibrary(const EngineIdType& DeviceId) const
+		{
+			const std::shared_ptr<const FDeviceSnapshot> Current = GetSnapshot();
+			if (!Current)
 			{
-				auto It = KnownDevicePaths.find(Path);
-				if (It != KnownDevicePaths.end())
+				return nullptr;
+			}
+
+			const std::shared_ptr<ISonyGamepad>* Gamepad = Current->Find(DeviceId);
+			return Gamepad ? *Gamepad : nullptr;
+		}
+
+		/**
+		 * Removes a gamepad from the device list. It is shut down and its
+		 * storage reclaimed once no snapshot references it anymore, so a
+		 * thread still holding one never writes through a closed handle.
+		 */
+		void RemoveLibraryInstance(EngineIdType DeviceId)
+		{
+			Policy.DisconnectDevice(DeviceId);
+			auto It = LibraryHandles.find(DeviceId);
+			if (It == LibraryHandles.end())
+			{
+				return;
+			}
+
+			if (FGamepadSlot* Slot = Libraries.Find(It->second))
+			{
+				if (ReaderEngine)
 				{
-					EngineIdType DeviceId = It->second;
-					RemoveLibraryInstance(DeviceId);
-					KnownDevicePaths.erase(It);
+					ReaderEngine->RemoveSource(Slot->Gamepad);
 				}
+				if (AudioEngine)
+				{
+					AudioEngine->RemoveSource(Slot->Gamepad->GetIGamepadHaptics());
+				}
+				RetiredLibraries.push_back(FRetiredLibrary{It->second, Slot->Shared});
+				Slot->Shared.reset();
 			}
+			Libraries.Unpublish(It->second);
+			LibraryHandles.erase(It);
+			PublishSnapshot();
+			ReclaimRetiredLibraries();
+		}
 
-			for (auto Context : DetectedDevices)
+		/**
+		 * Composes the output report of every connected gamepad and sends the
+		 * ones that changed since the last flush with a single WriteBatch call.
+		 *
+		 * Intended to replace per-device UpdateOutput calls once per frame.
+		 */
+		void FlushAllOutputs()
+		{
+			PendingOutputs.clear();
+			for (FGamepadSlot* Slot : Libraries)
 			{
-				Context.Output = FOutputContext();
-				if (bool IsCreateHandle = IPlatformHardwareInfo::Get().CreateHandle(&Context))
+				ISonyGamepad* Gamepad = Slot->Gamepad;
+				FDeviceContext* Context = Gamepad->GetMutableDeviceContext();
+				if (!Context)
+				{
+					continue;
+				}
+
+				Context->OutputMutex.lock();
+				if (Gamepad->PrepareOutput())
 				{
-					CreateLibrary(Context);
+					PendingOutputs.push_back(Context);
+					continue;
 				}
+				Context->OutputMutex.unlock();
+			}
+
+			if (PendingOutputs.empty())
+			{
+				return;
+			}
+
+			PolicyWriteBatch(GetHardware(), PendingOutputs);
+			for (FDeviceContext* Context : PendingOutputs)
+			{
+				Context->OutputMutex.unlock();
 			}
 		}
 
-		ISonyGamepad* GetLibrary(EngineIdType DeviceId)
+		/**
+		 * Hands the input of the registered gamepads, and of those connected
+		 * later, to a reader engine. Gamepads whose handle cannot be
+		 * multiplexed still need UpdateInput calls from the integration.
+		 *
+		 * @param Engine A running engine, or nullptr to stop using it.
+		 */
+		void SetReaderEngine(FGamepadReaderEngine* Engine)
 		{
-			if (LibraryInstances.contains(DeviceId))
+			for (FGamepadSlot* Slot : Libraries)
 			{
-				return LibraryInstances[DeviceId].get();
+				if (ReaderEngine)
+				{
+					ReaderEngine->RemoveSource(Slot->Gamepad);
+				}
+				Slot->bReadByEngine = Engine && Engine->AddSource(Slot->Gamepad, GetPollDescriptor(*Slot));
 			}
-			return nullptr;
+			ReaderEngine = Engine;
 		}
 
-		void RemoveLibraryInstance(EngineIdType DeviceId)
+		/**
+		 * Hands the haptics rendering of the registered gamepads, and of those
+		 * connected later, to an audio engine. Gamepads are unregistered
+		 * before they are shut down.
+		 *
+		 * @param Engine A running engine, or nullptr to stop using it.
+		 */
+		void SetAudioEngine(FGamepadAudioEngine* Engine)
 		{
-			Policy.DisconnectDevice(DeviceId);
-			if (LibraryInstances.contains(DeviceId))
+			for (FGamepadSlot* Slot : Libraries)
 			{
-				LibraryInstances[DeviceId]->ShutdownLibrary();
-				LibraryInstances.erase(DeviceId);
+				IGamepadAudioHaptics* Haptics = Slot->Gamepad->GetIGamepadHaptics();
+				if (AudioEngine)
+				{
+					AudioEngine->RemoveSource(Haptics);
+				}
+				if (Engine)
+				{
+					Engine->AddSource(Haptics);
+				}
 			}
+			AudioEngine = Engine;
 		}
 
+		/**
+		 * Spreads the per-gamepad work of Tick over a worker pool.
+		 *
+		 * @param Pool A started pool, or nullptr to tick on the caller.
+		 */
+		void SetTickPool(FGamepadWorkerPool* Pool)
+		{
+			TickPool = Pool;
+		}
+
+		/**
+		 * Runs one frame of every connected gamepad: reads and decodes its
+		 * input (unless the reader engine does), evaluates its effects and
+		 * composes its output report, then sends the changed reports with a
+		 * single WriteBatch call.
+		 *
+		 * The per-gamepad work runs in parallel on the tick pool, if any.
+		 * Gamepads share no state, and each one still publishes its input
+		 * through its own buffer swap. Replaces per-device UpdateInput calls
+		 * followed by FlushAllOutputs.
+		 */
+		void Tick(float DeltaTime)
+		{
+			TickSlots.assign(Libraries.begin(), Libraries.end());
+			TickOutputs.assign(TickSlots.size(), 0);
+
+			auto TickGamepad = [this, DeltaTime](std::size_t Index) {
+				FGamepadSlot* Slot = TickSlots[Index];
+				VisitLibrary(*Slot, [this, DeltaTime, Slot, Index](auto& Gamepad) {
+					if (!Slot->bReadByEngine)
+					{
+						Gamepad.UpdateInput(DeltaTime);
+					}
+
+					FDeviceContext* Context = Gamepad.GetMutableDeviceContext();
+					if (!Context)
+					{
+						return;
+					}
+
+					// Locked and unlocked on the same thread; the batch below
+					// locks again to send the composed report.
+					gc_lock::lock_guard<gc_lock::mutex> Lock(Context->OutputMutex);
+					TickOutputs[Index] = Gamepad.PrepareOutput() ? 1 : 0;
+				});
+			};
+
+			if (TickPool)
+			{
+				TickPool->ParallelFor(TickSlots.size(), TickGamepad);
+			}
+			else
+			{
+				for (std::size_t Index = 0; Index < TickSlots.size(); ++Index)
+				{
+					TickGamepad(Index);
+				}
+			}
+
+			PendingOutputs.clear();
+			for (std::size_t Index = 0; Index < TickSlots.size(); ++Index)
+			{
+				if (TickOutputs[Index])
+				{
+					FDeviceContext* Context = TickSlots[Index]->Gamepad->GetMutableDeviceContext();
+					Context->OutputMutex.lock();
+					PendingOutputs.push_back(Context);
+				}
+			}
+
+			if (PendingOutputs.empty())
+			{
+				return;
+			}
+
+			PolicyWriteBatch(GetHardware(), PendingOutputs);
+			for (FDeviceContext* Context : PendingOutputs)
+			{
+				Context->OutputMutex.unlock();
+			}
+		}
+
+		/**
+		 * Makes the next PlugAndPlay call detect devices. Safe from any thread.
+		 */
 		void RequestImmediateDetection()
 		{
-			TimeAccumulator = DetectionInterval;
+			bDetectionRequested.store(true, std::memory_order_release);
+		}
+
+		/**
+		 * Sets how often PlugAndPlay polls for devices. When the platform
+		 * reports device changes, polling only backs up the notifications and
+		 * the interval can be raised.
+		 *
+		 * @param Seconds Time between two detections.
+		 */
+		void SetDetectionInterval(float Seconds)
+		{
+			DetectionInterval.store(Seconds, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Moves detection, handle creation and initialization to a thread
+		 * owned by the registry. PlugAndPlay then only adopts the gamepads
+		 * that became ready and drops the removed ones, so no frame pays for
+		 * bus enumeration. Not available on embedded targets.
+		 *
+		 * @return False if the thread cannot start.
+		 */
+		bool StartBackgroundDiscovery()
+		{
+#if defined(GAMEPAD_CORE_EMBEDDED)
+			return false;
+#else
+			if (bDiscoveryRunning.load(std::memory_order_acquire))
+			{
+				return true;
+			}
+
+			if (!DiscoveryEvents.Initialize(DiscoveryQueueEvents, 1))
+			{
+				return false;
+			}
+
+			if (!DiscoveryLeases.Initialize(DiscoverySpareSlots, 1))
+			{
+				DiscoveryEvents.Release();
+				return false;
+			}
+
+			DiscoveredPaths.clear();
+			for (const auto& Path : KnownDevicePaths | std::views::keys)
+			{
+				DiscoveredPaths.emplace(Path, DiscoveryPass);
+			}
+
+			OutstandingLeases = 0;
+			LeaseDiscoverySlots();
+
+			bDiscoveryRunning.store(true, std::memory_order_release);
+			DiscoveryThread = std::thread(&TBasicDeviceRegistry::RunDiscovery, this);
+			return true;
+#endif
+		}
+
+		/**
+		 * Joins the discovery thread and adopts what it had already found;
+		 * PlugAndPlay detects on the calling thread again. Call it from the
+		 * thread that calls PlugAndPlay.
+		 */
+		void StopBackgroundDiscovery()
+		{
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+			if (!bDiscoveryRunning.exchange(false, std::memory_order_acq_rel))
+			{
+				return;
+			}
+
+			if (DiscoveryThread.joinable())
+			{
+				DiscoveryThread.join();
+			}
+
+			// Gamepads still initializing continue on the calling thread.
+			for (auto& Event : DiscoveryInitializing)
+			{
+				DiscoveryBacklog.push_back(std::move(Event));
+			}
+			DiscoveryInitializing.clear();
+
+			do
+			{
+				FlushDiscoveryBacklog();
+				DrainDiscoveryEvents();
+			} while (!DiscoveryBacklog.empty());
+
+			// Return the slots leased but never used.
+			CollectDiscoveryLeases();
+			for (const FSlotLease& Lease : DiscoverySpares)
+			{
+				Libraries.Remove(Lease.Handle);
+			}
+			DiscoverySpares.clear();
+			OutstandingLeases = 0;
+
+			DiscoveryEvents.Release();
+			DiscoveryLeases.Release();
+#endif
+		}
+
+		/**
+		 * Subscribes to the device notifications of the platform, if it has
+		 * any. Arrivals and removals then trigger a detection on the next
+		 * PlugAndPlay call; polling keeps running as a fallback.
+		 *
+		 * @return False if the platform cannot watch devices.
+		 */
+		bool WatchDevices()
+		{
+			if (!bWatchingDevices)
+			{
+				bWatchingDevices = PolicyWatchDevices(GetHardware(), this);
+			}
+			return bWatchingDevices;
+		}
+
+		/**
+		 * Unsubscribes from the device notifications of the platform.
+		 */
+		void StopWatchingDevices()
+		{
+			if (bWatchingDevices)
+			{
+				PolicyWatchDevices(GetHardware(), nullptr);
+				bWatchingDevices = false;
+			}
 		}
 
 	private:
-		void CreateLibrary(FDeviceContext& Context)
+		virtual void OnDeviceChanged(EDSDeviceChange Change, const std::string& Path) override
+		{
+			// Arrivals and removals are both resolved by the next detection,
+			// on the thread that owns the registry.
+			(void)Change;
+			(void)Path;
+			RequestImmediateDetection();
+		}
+
+		/**
+		 * Discovery thread: detects on the interval or when requested,
+		 * advances the initializations and publishes the results.
+		 */
+		void RunDiscovery()
+		{
+			std::uint64_t NextDetectionUs = 0;
+			while (bDiscoveryRunning.load(std::memory_order_acquire))
+			{
+				const std::uint64_t NowUs = gc_time::now_us();
+				const bool bLeasesArrived = bAwaitingLeases && DiscoveryLeases.GetQueuedElements() > 0;
+				if (bDetectionRequested.exchange(false, std::memory_order_acq_rel) || bLeasesArrived || NowUs >= NextDetectionUs)
+				{
+					NextDetectionUs = NowUs + static_cast<std::uint64_t>(DetectionInterval.load(std::memory_order_relaxed) * 1000000.0f);
+					DiscoverDevices();
+				}
+
+				std::erase_if(DiscoveryInitializing, [this](std::unique_ptr<FDiscoveryEvent>& Event) {
+					if (!Event->Lease.Slot->Gamepad->AdvanceInitialization())
+					{
+						return false;
+					}
+
+					DiscoveryBacklog.push_back(std::move(Event));
+					return true;
+				});
+
+				FlushDiscoveryBacklog();
+				gc_sync::sleep_ms(DiscoveryPollMs);
+			}
+		}
+
+		/**
+		 * Discovery thread: opens and initializes new paths and reports the
+		 * ones that disappeared.
+		 */
+		void DiscoverDevices()
+		{
+			DiscoveryDevices.clear();
+			GetHardware().Detect(DiscoveryDevices);
+			CollectDiscoveryLeases();
+
+			const std::uint32_t Pass = ++DiscoveryPass;
+			bAwaitingLeases = false;
+			for (FDeviceContext& Context : DiscoveryDevices)
+			{
+				auto It = DiscoveredPaths.find(Context.Path);
+				if (It != DiscoveredPaths.end())
+				{
+					It->second = Pass;
+					continue;
+				}
+
+				if (DiscoverySpares.empty())
+				{
+					// Out of leased slots: try again once the registry leases
+					// more, or on the next interval.
+					bAwaitingLeases = true;
+					break;
+				}
+
+				const FSlotLease Lease = DiscoverySpares.back();
+				Context.Output = FOutputContext();
+				if (!OpenLibrary(Context, *Lease.Slot))
+				{
+					continue;
+				}
+
+				DiscoverySpares.pop_back();
+				DiscoveredPaths.emplace(Context.Path, Pass);
+				auto Event = std::make_unique<FDiscoveryEvent>();
+				Event->Change = EDSDeviceChange::Arrived;
+				Event->Path = Context.Path;
+				Event->Lease = Lease;
+				DiscoveryInitializing.push_back(std::move(Event));
+			}
+
+			// An interrupted pass did not see every path.
+			if (!bAwaitingLeases)
+			{
+				RemoveUndiscoveredPaths(Pass);
+			}
+		}
+
+		/**
+		 * Discovery thread: reports the paths not seen by the last complete
+		 * detection.
+		 */
+		void RemoveUndiscoveredPaths(std::uint32_t Pass)
+		{
+			std::erase_if(DiscoveredPaths, [this, Pass](const auto& Entry) {
+				if (Entry.second == Pass)
+				{
+					return false;
+				}
+
+				// Gone before it was handed over: close it here.
+				auto Pending = std::ranges::find_if(DiscoveryInitializing, [&Entry](const auto& Event) {
+					return Event->Path == Entry.first;
+				});
+				if (Pending != DiscoveryInitializing.end())
+				{
+					FGamepadSlot& Slot = *(*Pending)->Lease.Slot;
+					Slot.Gamepad->ShutdownLibrary();
+					ResetSlot(Slot);
+					DiscoverySpares.push_back((*Pending)->Lease);
+					DiscoveryInitializing.erase(Pending);
+					return true;
+				}
+
+				auto Event = std::make_unique<FDiscoveryEvent>();
+				Event->Change = EDSDeviceChange::Removed;
+				Event->Path = Entry.first;
+				DiscoveryBacklog.push_back(std::move(Event));
+				return true;
+			});
+		}
+
+		/**
+		 * Discovery thread: publishes the backlog in order, keeping what does
+		 * not fit for the next round.
+		 */
+		void FlushDiscoveryBacklog()
+		{
+			std::size_t Published = 0;
+			for (; Published < DiscoveryBacklog.size(); ++Published)
+			{
+				FDiscoveryEvent** Block = DiscoveryEvents.AcquireWrite();
+				if (!Block)
+				{
+					break;
+				}
+
+				*Block = DiscoveryBacklog[Published].release();
+				DiscoveryEvents.CommitWrite(1);
+			}
+			DiscoveryBacklog.erase(DiscoveryBacklog.begin(), DiscoveryBacklog.begin() + static_cast<std::ptrdiff_t>(Published));
+		}
+
+		/**
+		 * Adopts the gamepads published by the discovery thread and removes
+		 * the ones it reported gone.
+		 */
+		void DrainDiscoveryEvents()
+		{
+			std::size_t Elements = 0;
+			while (FDiscoveryEvent* const* Block = DiscoveryEvents.AcquireRead(Elements))
+			{
+				std::unique_ptr<FDiscoveryEvent> Event(*Block);
+				DiscoveryEvents.ConsumeElements(Elements);
+				DiscoveryEvents.CommitRead();
+
+				if (Event->Change == EDSDeviceChange::Arrived)
+				{
+					--OutstandingLeases;
+					AdoptLibrary(Event->Path, Event->Lease.Handle, DetectionPass);
+					continue;
+				}
+
+				auto It = KnownDevicePaths.find(Event->Path);
+				if (It != KnownDevicePaths.end())
+				{
+					EngineIdType DeviceId = It->second.DeviceId;
+					KnownDevicePaths.erase(It);
+					RemoveLibraryInstance(DeviceId);
+				}
+			}
+		}
+
+		/**
+		 * Publishes the current device list for readers on other threads.
+		 */
+		void PublishSnapshot()
+		{
+			auto Next = std::make_shared<FDeviceSnapshot>();
+			Next->Devices.reserve(LibraryHandles.size());
+			for (const auto& [DeviceId, Handle] : LibraryHandles)
+			{
+				if (const FGamepadSlot* Slot = Libraries.Find(Handle))
+				{
+					Next->Devices.push_back({DeviceId, Slot->Shared});
+				}
+			}
+			Snapshot.store(std::move(Next), std::memory_order_release);
+		}
+
+		/**
+		 * Shuts down and destroys the removed gamepads no snapshot references
+		 * anymore.
+		 */
+		void ReclaimRetiredLibraries()
+		{
+			std::erase_if(RetiredLibraries, [this](const FRetiredLibrary& Retired) {
+				if (!Retired.Reference.expired())
+				{
+					return false;
+				}
+
+				if (FGamepadSlot* Slot = Libraries.FindReserved(Retired.Handle))
+				{
+					if (Slot->Gamepad)
+					{
+						Slot->Gamepad->ShutdownLibrary();
+					}
+					ResetSlot(*Slot);
+				}
+				Libraries.Remove(Retired.Handle);
+				return true;
+			});
+		}
+
+		/**
+		 * Reserves slots for the discovery thread until it holds
+		 * DiscoverySpareSlots of them.
+		 */
+		void LeaseDiscoverySlots()
+		{
+			while (OutstandingLeases < DiscoverySpareSlots)
+			{
+				FSlotLease* Block = DiscoveryLeases.AcquireWrite();
+				if (!Block)
+				{
+					return;
+				}
+
+				const FSlotHandle Handle = Libraries.Reserve();
+				*Block = FSlotLease{Handle, Libraries.FindReserved(Handle)};
+				DiscoveryLeases.CommitWrite(1);
+				++OutstandingLeases;
+			}
+		}
+
+		/**
+		 * Discovery thread: takes the slots leased by the registry.
+		 */
+		void CollectDiscoveryLeases()
+		{
+			std::size_t Elements = 0;
+			while (const FSlotLease* Block = DiscoveryLeases.AcquireRead(Elements))
+			{
+				DiscoverySpares.push_back(*Block);
+				DiscoveryLeases.ConsumeElements(Elements);
+				DiscoveryLeases.CommitRead();
+			}
+		}
+
+		/**
+		 * Moves forward the gamepads whose initialization is still pending and
+		 * announces the ones that became ready. Runs on every PlugAndPlay call,
+		 * so several devices connecting together initialize in parallel.
+		 */
+		void AdvancePendingInitializations()
+		{
+			std::erase_if(PendingInitializations, [this](const EngineIdType& DeviceId) {
+				ISonyGamepad* Gamepad = GetLibrary(DeviceId);
+				if (!Gamepad)
+				{
+					return true;
+				}
+
+				if (!Gamepad->AdvanceInitialization())
+				{
+					return false;
+				}
+
+				Policy.DispatchNewGamepad(DeviceId);
+				return true;
+			});
+		}
+
+		/**
+		 * Constructs the library matching the device in a slot, opens the
+		 * device and initializes the library.
+		 *
+		 * @return False, with the slot left empty, if the device is not
+		 * supported or cannot be opened.
+		 */
+		bool OpenLibrary(FDeviceContext& Context, FGamepadSlot& Slot)
 		{
-			std::shared_ptr<ISonyGamepad> Gamepad = nullptr;
 			if (Context.DeviceType == EDSDeviceType::DualSense || Context.DeviceType == EDSDeviceType::DualSenseEdge)
 			{
-				Gamepad = std::make_shared<FDualSenseLibrary>();
+				Slot.Gamepad = &EmplaceLibrary<FDualSense>(Slot);
 			}
 
 			if (Context.DeviceType == EDSDeviceType::DualShock4)
 			{
-				Gamepad = std::make_shared<FDualShockLibrary>();
+				Slot.Gamepad = &EmplaceLibrary<FDualShock>(Slot);
 			}
 
-			if (!Gamepad)
+			if (!Slot.Gamepad)
 			{
-				return;
+				return false;
 			}
 
-			if (!HistoryDevices.contains(Context.Path))
+			if (!GetHardware().CreateHandle(&Context))
 			{
-				HistoryDevices[Context.Path] = Policy.AllocEngineDevice();
+				ResetSlot(Slot);
+				return false;
 			}
 
-			auto DeviceId = HistoryDevices[Context.Path];
-			if (!LibraryInstances.contains(DeviceId))
+			Slot.Gamepad->Initialize(Context);
+			return true;
+		}
+
+		/**
+		 * Constructs a library in a slot, bound to the policy of the registry
+		 * if it has one.
+		 */
+		template<typename TLibrary>
+		TLibrary& EmplaceLibrary(FGamepadSlot& Slot)
+		{
+			if constexpr (bStaticHardware)
 			{
-				Gamepad->Initialize(Context);
-				LibraryInstances[DeviceId] = Gamepad;
-				KnownDevicePaths[Context.Path] = DeviceId;
-				Policy.DispatchNewGamepad(DeviceId);
+				return Slot.Library.template emplace<TLibrary>(*Hardware);
+			}
+			else
+			{
+				return Slot.Library.template emplace<TLibrary>();
+			}
+		}
+
+		/**
+		 * @return The policy the registry is bound to, or the singleton.
+		 */
+		FHardware& GetHardware()
+		{
+			if constexpr (bStaticHardware)
+			{
+				return *Hardware;
+			}
+			else
+			{
+				return IPlatformHardwareInfo::Get();
+			}
+		}
+
+		/**
+		 * Calls Func with the library of a slot as its concrete type, so the
+		 * calls of a statically bound library skip its vtable.
+		 */
+		template<typename TFunc>
+		static void VisitLibrary(FGamepadSlot& Slot, TFunc&& Func)
+		{
+			std::visit([&Func](auto& Library) {
+				if constexpr (!std::is_same_v<std::decay_t<decltype(Library)>, std::monostate>)
+				{
+					Func(Library);
+				}
+			},
+			           Slot.Library);
+		}
+
+		/**
+		 * @return The poll descriptor of a slot's handle, resolved through the
+		 * bound hardware, or -1 if it has none.
+		 */
+		std::intptr_t GetPollDescriptor(FGamepadSlot& Slot)
+		{
+			FDeviceContext* Context = Slot.Gamepad->GetMutableDeviceContext();
+			return Context ? PolicyGetPollDescriptor(GetHardware(), Context) : -1;
+		}
+
+		/**
+		 * Destroys the library held by a slot.
+		 */
+		static void ResetSlot(FGamepadSlot& Slot)
+		{
+			Slot.Library.template emplace<std::monostate>();
+			Slot.Gamepad = nullptr;
+			Slot.Shared.reset();
+			Slot.bReadByEngine = false;
+		}
+
+		/**
+		 * Publishes an initialized library under the engine id of its path
+		 * and announces it once ready.
+		 */
+		void AdoptLibrary(const std::string& Path, FSlotHandle Handle, std::uint32_t Pass)
+		{
+			if (!HistoryDevices.contains(Path))
+			{
+				HistoryDevices[Path] = Policy.AllocEngineDevice();
+			}
+
+			auto DeviceId = HistoryDevices[Path];
+			FGamepadSlot* Slot = Libraries.FindReserved(Handle);
+			if (LibraryHandles.contains(DeviceId))
+			{
+				Slot->Gamepad->ShutdownLibrary();
+				ResetSlot(*Slot);
+				Libraries.Remove(Handle);
+				return;
+			}
+
+			// The shared reference only counts readers; the slot owns the library.
+			Slot->Shared = std::shared_ptr<ISonyGamepad>(Slot->Gamepad, [](ISonyGamepad*) {});
+			Libraries.Publish(Handle);
+			LibraryHandles.emplace(DeviceId, Handle);
+			PublishSnapshot();
+			Slot->bReadByEngine = ReaderEngine && ReaderEngine->AddSource(Slot->Gamepad, GetPollDescriptor(*Slot));
+			if (AudioEngine)
+			{
+				AudioEngine->AddSource(Slot->Gamepad->GetIGamepadHaptics());
+			}
+			KnownDevicePaths[Path] = FKnownDevice{DeviceId, Pass};
+			if (!Slot->Gamepad->IsReady())
+			{
+				PendingInitializations.push_back(DeviceId);
+				return;
 			}
+			Policy.DispatchNewGamepad(DeviceId);
 		}
 	};
 } // namespace GamepadCore
@@ -33,6 +33,137 @@ namespace GamepadCore
 		} -> std::same_as<void>;
 	};
 
+	/**
+	 * Optional policy extension: a policy exposing WriteBatch receives every
+	 * dirty output report of a frame in one call instead of one Write each.
+	 */
+	template<typename T>
+	concept HasBatchWrite = requires(T t, std::span<FDeviceContext*> ctxs) {
+		{
+			t.WriteBatch(ctxs)
+		} -> std::same_as<void>;
+	};
+
+	/**
+	 * Optional policy extension: a policy exposing WatchDevices reports device
+	 * arrival and removal as they happen, so detection does not wait for the
+	 * next poll.
+	 */
+	template<typename T>
+	concept HasDeviceWatch = requires(T t, IDeviceChangeListener* Listener) {
+		{
+			t.WatchDevices(Listener)
+		} -> std::same_as<bool>;
+	};
+
+	/**
+	 * Optional policy extension: a policy exposing GetPollDescriptor lets the
+	 * reader engine wait on all of its handles at once.
+	 */
+	template<typename T>
+	concept HasPollDescriptor = requires(T t, FDeviceContext* ctx) {
+		{
+			t.GetPollDescriptor(ctx)
+		} -> std::same_as<std::intptr_t>;
+	};
+
+	/**
+	 * Optional policy extension: a policy exposing ReadAll hands every queued
+	 * input report to a sink, so a drain does not skip the older ones.
+	 */
+	template<typename T>
+	concept HasReadAll = requires(T t, FDeviceContext* ctx, IInputReportSink* Sink) {
+		{
+			t.ReadAll(ctx, Sink)
+		} -> std::same_as<std::size_t>;
+	};
+
+	/**
+	 * Reads every queued report through ReadAll if the policy has it, or
+	 * reads once and hands the report to Sink.
+	 *
+	 * @return The number of reports handed to Sink.
+	 */
+	template<typename THardware>
+	std::size_t PolicyReadAll(THardware& Hardware, FDeviceContext* Context, IInputReportSink* Sink)
+	{
+		if constexpr (HasReadAll<THardware>)
+		{
+			return Hardware.ReadAll(Context, Sink);
+		}
+		else
+		{
+			Hardware.Read(Context);
+			Sink->OnInputReport(Context);
+			return 1;
+		}
+	}
+
+	/**
+	 * Sends a batch of output reports through WriteBatch if the policy has
+	 * it, or one Write each.
+	 */
+	template<typename THardware>
+	void PolicyWriteBatch(THardware& Hardware, std::span<FDeviceContext*> Contexts)
+	{
+		if constexpr (HasBatchWrite<THardware>)
+		{
+			Hardware.WriteBatch(Contexts);
+		}
+		else
+		{
+			for (FDeviceContext* Context : Contexts)
+			{
+				Hardware.Write(Context);
+			}
+		}
+	}
+
+	/**
+	 * Forwards to WatchDevices if the policy has it.
+	 *
+	 * @return False if the policy cannot watch devices.
+	 */
+	template<typename THardware>
+	bool PolicyWatchDevices(THardware& Hardware, IDeviceChangeListener* Listener)
+	{
+		if constexpr (HasDeviceWatch<THardware>)
+		{
+			return Hardware.WatchDevices(Listener);
+		}
+		else
+		{
+			(void)Hardware;
+			(void)Listener;
+			return false;
+		}
+	}
+
+	/**
+	 * Forwards to GetPollDescriptor if the policy has it.
+	 *
+	 * @return -1 if the policy has no descriptor to wait on.
+	 */
+	template<typename THardware>
+	std::intptr_t PolicyGetPollDescriptor(THardware& Hardware, FDeviceContext* Context)
+	{
+		if constexpr (HasPollDescriptor<THardware>)
+		{
+			return Hardware.GetPollDescriptor(Context);
+		}
+		else
+		{
+			(void)Hardware;
+			(void)Context;
+			return -1;
+		}
+	}
+
+	/**
+	 * Adapts a policy to the IPlatformHardwareInfo singleton. Code bound to
+	 * the policy at compile time, such as a TBasicDeviceRegistry given its
+	 * type, can share the same instance through GetPolicy.
+	 */
 	template<typename THardwarePolicy>
 	class TGenericHardwareInfo : public IPlatformHardwareInfo
 	{
@@ -46,16 +177,31 @@ namespace GamepadCore
 			Policy.Read(Context);
 		}
 
+		std::size_t ReadAll(FDeviceContext* Context, IInputReportSink* Sink) override
+		{
+			return PolicyReadAll(Policy, Context, Sink);
+		}
+
 		void Write(FDeviceContext* Context) override
 		{
 			Policy.Write(Context);
 		}
 
+		void WriteBatch(std::span<FDeviceContext*> Contexts) override
+		{
+			PolicyWriteBatch(Policy, Contexts);
+		}
+
 		void Detect(std::vector<FDeviceContext>& Devices) override
 		{
 			Policy.Detect(Devices);
 		}
 
+		bool WatchDevices(IDeviceChangeListener* Listener) override
+		{
+			return PolicyWatchDevices(Policy, Listener);
+		}
+
 		bool CreateHandle(FDeviceContext* Context) override
 		{
 			return Policy.CreateHandle(Context);
@@ -66,6 +212,11 @@ namespace GamepadCore
 			Policy.InvalidateHandle(Context);
 		}
 
+		std::intptr_t GetPollDescriptor(FDeviceContext* Context) override
+		{
+			return PolicyGetPollDescriptor(Policy, Context);
+		}
+
 		void ProcessAudioHaptic(FDeviceContext* Context) override
 		{
 			Policy.ProcessAudioHaptic(Context);
@@ -0,0 +1,228 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace GamepadCore
+{
+	/**
+	 * @brief Generational slot map with in-place, address-stable storage.
+	 *
+	 * Values live in fixed-size pages that are never moved, so a slot can hold
+	 * a non-movable object and pointers to it stay valid until it is removed.
+	 * Every value is default-constructed with its page; callers reset a slot
+	 * themselves when they remove it.
+	 *
+	 * A slot is first reserved, which hands out a handle without making the
+	 * slot visible, then published, which makes it visible to Find and
+	 * iteration. Iteration walks the slots in index order and skips the ones
+	 * that are free or not published. Removing a slot bumps its generation,
+	 * so stale handles are rejected in O(1).
+	 *
+	 * @tparam TValue Default-constructible value type.
+	 * @tparam PageSize Slots per page.
+	 */
+	template<typename TValue, std::size_t PageSize = 8>
+	class TSlotMap
+	{
+	public:
+		/**
+		 * Stable reference to a slot. Becomes invalid when the slot is removed.
+		 */
+		struct FHandle
+		{
+			std::uint32_t Index = std::numeric_limits<std::uint32_t>::max();
+			std::uint32_t Generation = 0;
+
+			bool IsValid() const { return Index != std::numeric_limits<std::uint32_t>::max(); }
+			bool operator==(const FHandle&) const = default;
+		};
+
+		/**
+		 * Forward iterator over the published values, yielding TValue*.
+		 */
+		class FIterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = TValue*;
+			using difference_type = std::ptrdiff_t;
+			using pointer = TValue* const*;
+			using reference = TValue*;
+
+			FIterator() = default;
+
+			TValue* operator*() const { return Map->GetValue(Index); }
+
+			FIterator& operator++()
+			{
+				++Index;
+				SkipUnpublished();
+				return *this;
+			}
+
+			FIterator operator++(int)
+			{
+				FIterator Previous = *this;
+				++*this;
+				return Previous;
+			}
+
+			bool operator==(const FIterator& Other) const { return Index == Other.Index; }
+
+		private:
+			friend class TSlotMap;
+
+			FIterator(const TSlotMap* InMap, std::uint32_t InIndex)
+			    : Map(InMap)
+			    , Index(InIndex)
+			{
+				SkipUnpublished();
+			}
+
+			void SkipUnpublished()
+			{
+				while (Index < Map->Slots.size() && !Map->Slots[Index].bPublished)
+				{
+					++Index;
+				}
+			}
+
+			const TSlotMap* Map = nullptr;
+			std::uint32_t Index = 0;
+		};
+
+		TSlotMap() = default;
+		TSlotMap(const TSlotMap&) = delete;
+		TSlotMap& operator=(const TSlotMap&) = delete;
+
+		/**
+		 * Takes a free slot (allocating a page if needed) without publishing
+		 * it. The value keeps the state it was left in.
+		 */
+		FHandle Reserve()
+		{
+			if (FreeSlots.empty())
+			{
+				const std::size_t First = Pages.size() * PageSize;
+				Pages.push_back(std::make_unique<TValue[]>(PageSize));
+				Slots.resize(First + PageSize);
+				for (std::size_t Index = First + PageSize; Index > First; --Index)
+				{
+					FreeSlots.push_back(static_cast<std::uint32_t>(Index - 1));
+				}
+			}
+
+			const std::uint32_t Index = FreeSlots.back();
+			FreeSlots.pop_back();
+			FSlot& Slot = Slots[Index];
+			Slot.bReserved = true;
+			return FHandle{Index, Slot.Generation};
+		}
+
+		/**
+		 * Makes a reserved slot visible to Find and iteration.
+		 */
+		void Publish(FHandle Handle)
+		{
+			if (!IsReserved(Handle) || Slots[Handle.Index].bPublished)
+			{
+				return;
+			}
+
+			Slots[Handle.Index].bPublished = true;
+			++NumPublished;
+		}
+
+		/**
+		 * Hides a published slot from Find and iteration while keeping it
+		 * reserved, e.g. until its value can be reclaimed.
+		 */
+		void Unpublish(FHandle Handle)
+		{
+			if (!IsReserved(Handle) || !Slots[Handle.Index].bPublished)
+			{
+				return;
+			}
+
+			Slots[Handle.Index].bPublished = false;
+			--NumPublished;
+		}
+
+		/**
+		 * Frees a reserved or published slot and invalidates its handles.
+		 */
+		void Remove(FHandle Handle)
+		{
+			if (!IsReserved(Handle))
+			{
+				return;
+			}
+
+			Unpublish(Handle);
+			FSlot& Slot = Slots[Handle.Index];
+			Slot.bReserved = false;
+			++Slot.Generation;
+			FreeSlots.push_back(Handle.Index);
+		}
+
+		/**
+		 * @return The value of a published slot, or nullptr if the handle is
+		 * stale or not published.
+		 */
+		TValue* Find(FHandle Handle) const
+		{
+			if (!IsReserved(Handle) || !Slots[Handle.Index].bPublished)
+			{
+				return nullptr;
+			}
+			return GetValue(Handle.Index);
+		}
+
+		/**
+		 * @return The value of a reserved slot, published or not, or nullptr
+		 * if the handle is stale.
+		 */
+		TValue* FindReserved(FHandle Handle) const
+		{
+			return IsReserved(Handle) ? GetValue(Handle.Index) : nullptr;
+		}
+
+		/** @return The number of published slots. */
+		std::size_t Num() const { return NumPublished; }
+
+		/** Iterates over the published values in slot order. */
+		FIterator begin() const { return FIterator(this, 0); }
+		FIterator end() const { return FIterator(this, static_cast<std::uint32_t>(Slots.size())); }
+
+	private:
+		struct FSlot
+		{
+			std::uint32_t Generation = 0;
+			bool bReserved = false;
+			bool bPublished = false;
+		};
+
+		bool IsReserved(FHandle Handle) const
+		{
+			return Handle.Index < Slots.size() && Slots[Handle.Index].bReserved && Slots[Handle.Index].Generation == Handle.Generation;
+		}
+
+		TValue* GetValue(std::uint32_t Index) const
+		{
+			return &Pages[Index / PageSize][Index % PageSize];
+		}
+
+		std::vector<std::unique_ptr<TValue[]>> Pages;
+		std::vector<FSlot> Slots;
+		std::vector<std::uint32_t> FreeSlots;
+		std::size_t NumPublished = 0;
+	};
+} // namespace GamepadCore
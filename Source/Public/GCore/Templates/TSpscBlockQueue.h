@@ -0,0 +1,190 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace GamepadCore
+{
+	/**
+	 * Size used to keep data touched by different threads on separate cache
+	 * lines.
+	 */
+	inline constexpr std::size_t CacheLineSize = 64;
+
+	/**
+	 * @brief Single-producer/single-consumer queue of fixed-size blocks.
+	 *
+	 * All blocks are allocated once by Initialize, each one aligned to a cache
+	 * line. The producer fills the next free block in place and commits it; the
+	 * consumer reads committed blocks in order and releases them. Every
+	 * operation is a bounded number of atomic loads/stores, so both sides are
+	 * wait-free and never allocate.
+	 *
+	 * A committed block may be partially filled; its valid element count is
+	 * stored with it.
+	 *
+	 * @tparam TElement Trivially copyable element type (e.g. float samples).
+	 */
+	template<typename TElement>
+	class TSpscBlockQueue
+	{
+	public:
+		TSpscBlockQueue() = default;
+		TSpscBlockQueue(const TSpscBlockQueue&) = delete;
+		TSpscBlockQueue& operator=(const TSpscBlockQueue&) = delete;
+
+		~TSpscBlockQueue()
+		{
+			Release();
+		}
+
+		/**
+		 * Allocates the blocks. Must not run while either side is using the
+		 * queue.
+		 *
+		 * @param InBlockCount The number of blocks in the queue.
+		 * @param InBlockElements The capacity of a block, in elements.
+		 * @return False if the arguments are invalid or the allocation failed.
+		 */
+		bool Initialize(std::size_t InBlockCount, std::size_t InBlockElements)
+		{
+			Release();
+			if (InBlockCount == 0 || InBlockElements == 0)
+			{
+				return false;
+			}
+
+			// Round each block up to whole cache lines so neighbouring blocks
+			// never share one.
+			const std::size_t BlockBytes = InBlockElements * sizeof(TElement);
+			BlockStride = ((BlockBytes + CacheLineSize - 1) / CacheLineSize) * CacheLineSize;
+
+			Storage = static_cast<std::byte*>(::operator new(BlockStride * InBlockCount, std::align_val_t(CacheLineSize), std::nothrow));
+			Counts = std::make_unique<std::uint32_t[]>(InBlockCount);
+			if (!Storage || !Counts)
+			{
+				Release();
+				return false;
+			}
+
+			BlockCount = InBlockCount;
+			BlockElements = InBlockElements;
+			Head.store(0, std::memory_order_relaxed);
+			Tail.store(0, std::memory_order_relaxed);
+			QueuedElements.store(0, std::memory_order_relaxed);
+			return true;
+		}
+
+		/**
+		 * Frees the blocks. Must not run while either side is using the queue.
+		 */
+		void Release()
+		{
+			if (Storage)
+			{
+				::operator delete(Storage, std::align_val_t(CacheLineSize));
+				Storage = nullptr;
+			}
+			Counts.reset();
+			BlockCount = 0;
+			BlockElements = 0;
+		}
+
+		bool IsInitialized() const { return Storage != nullptr; }
+
+		/** @return The capacity of a block, in elements. */
+		std::size_t GetBlockElements() const { return BlockElements; }
+
+		/** @return The number of blocks in the queue. */
+		std::size_t GetBlockCount() const { return BlockCount; }
+
+		/** @return The elements committed and not yet released. Safe from either side. */
+		std::size_t GetQueuedElements() const { return QueuedElements.load(std::memory_order_acquire); }
+
+		/**
+		 * Producer: returns the next free block, or nullptr if the queue is full.
+		 * The same block is returned until it is committed.
+		 */
+		TElement* AcquireWrite()
+		{
+			const std::size_t WriteIndex = Head.load(std::memory_order_relaxed);
+			if (WriteIndex - Tail.load(std::memory_order_acquire) >= BlockCount)
+			{
+				return nullptr;
+			}
+			return GetBlock(WriteIndex);
+		}
+
+		/**
+		 * Producer: publishes the block returned by AcquireWrite.
+		 *
+		 * @param Elements The number of valid elements written to the block.
+		 */
+		void CommitWrite(std::size_t Elements)
+		{
+			const std::size_t WriteIndex = Head.load(std::memory_order_relaxed);
+			Counts[WriteIndex % BlockCount] = static_cast<std::uint32_t>(Elements);
+			QueuedElements.fetch_add(Elements, std::memory_order_relaxed);
+			Head.store(WriteIndex + 1, std::memory_order_release);
+		}
+
+		/**
+		 * Consumer: returns the oldest committed block, or nullptr if the queue
+		 * is empty.
+		 *
+		 * @param OutElements Receives the number of valid elements in the block.
+		 */
+		const TElement* AcquireRead(std::size_t& OutElements)
+		{
+			const std::size_t ReadIndex = Tail.load(std::memory_order_relaxed);
+			if (ReadIndex == Head.load(std::memory_order_acquire))
+			{
+				OutElements = 0;
+				return nullptr;
+			}
+
+			OutElements = Counts[ReadIndex % BlockCount];
+			return GetBlock(ReadIndex);
+		}
+
+		/**
+		 * Consumer: accounts for elements read from the current block without
+		 * releasing it, so the queued count follows partial reads.
+		 */
+		void ConsumeElements(std::size_t Elements)
+		{
+			QueuedElements.fetch_sub(Elements, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Consumer: returns the block obtained from AcquireRead to the producer.
+		 */
+		void CommitRead()
+		{
+			const std::size_t ReadIndex = Tail.load(std::memory_order_relaxed);
+			Tail.store(ReadIndex + 1, std::memory_order_release);
+		}
+
+	private:
+		TElement* GetBlock(std::size_t Index) const
+		{
+			return reinterpret_cast<TElement*>(Storage + ((Index % BlockCount) * BlockStride));
+		}
+
+		alignas(CacheLineSize) std::atomic<std::size_t> Head = 0;
+		alignas(CacheLineSize) std::atomic<std::size_t> Tail = 0;
+		alignas(CacheLineSize) std::atomic<std::size_t> QueuedElements = 0;
+
+		alignas(CacheLineSize) std::byte* Storage = nullptr;
+		std::unique_ptr<std::uint32_t[]> Counts;
+		std::size_t BlockCount = 0;
+		std::size_t BlockElements = 0;
+		std::size_t BlockStride = 0;
+	};
+} // namespace GamepadCore
@@ -12,6 +12,7 @@
 #include <cstring>
 #include <memory> // std::unique_ptr, std::make_unique
 #include <mutex>
+#include <span>          // std::span
 #include <string>        // std::string
 #include <unordered_map> // std::unordered_map
 #include <unordered_set> // std::unordered_set
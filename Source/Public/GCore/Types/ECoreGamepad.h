@@ -50,6 +50,26 @@ enum class EDSGamepadHand : std::uint8_t
 	AnyHand
 };
 
+/**
+ * @brief Blending applied while a trigger sequence moves towards a keyframe.
+ */
+enum class EDSTriggerBlend : std::uint8_t
+{
+	Step,
+	Linear
+};
+
+/**
+ * @brief Stages of the gamepad initialization. Bluetooth DualSense pads wait
+ * for the enable report to be acknowledged before normal output starts.
+ */
+enum class EDSInitializationState : std::uint8_t
+{
+	Uninitialized,
+	WaitingEnableReport,
+	Ready
+};
+
 enum class EDSDeviceType : std::uint8_t
 {
 	DualSense,
@@ -65,6 +85,12 @@ enum class EDSDeviceConnection : std::uint8_t
 	Unrecognized
 };
 
+enum class EDSDeviceChange : std::uint8_t
+{
+	Arrived,
+	Removed
+};
+
 class ECoreGamepad
 {
 };
@@ -0,0 +1,47 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Types/DSCoreTypes.h"
+
+/**
+ * @brief Settings of the Bluetooth link scheduler.
+ *
+ * Haptic packets leave at the controller haptic cadence (32 frames at 3 kHz,
+ * one every 10.67 ms). Output reports are coalesced and sent in the middle
+ * of the gaps between packets, at most MaxOutputReportsPerSecond.
+ */
+struct FBluetoothLinkConfig
+{
+	/** Haptic packets buffered ahead of the link; newer packets are dropped when full. */
+	std::uint32_t MaxQueuedPackets = 4;
+	/** Bandwidth budget for output reports (lightbar, triggers, rumble). */
+	std::uint32_t MaxOutputReportsPerSecond = 100;
+	/** The scheduler sleeps until this long before a slot, then spins. */
+	std::uint32_t SpinWindowUs = 1000;
+	/** A packet sent later than this after its slot counts as late. */
+	std::uint32_t LateThresholdUs = 2000;
+};
+
+/**
+ * @brief Counters of the Bluetooth link scheduler, accumulated since it
+ * started.
+ */
+struct FBluetoothLinkStats
+{
+	/** Haptic packets sent. */
+	std::uint64_t SentPackets = 0;
+	/** Haptic packets discarded because the queue was full. */
+	std::uint64_t DroppedPackets = 0;
+	/** Haptic packets sent later than the late threshold. */
+	std::uint64_t LatePackets = 0;
+	/** Slots that passed with no haptic packet queued. */
+	std::uint64_t EmptySlots = 0;
+	/** Output reports sent. */
+	std::uint64_t SentOutputReports = 0;
+	/** Gaps in which a pending output report had to wait for the budget. */
+	std::uint64_t DeferredOutputReports = 0;
+	/** Largest delay seen between a slot and its packet, in microseconds. */
+	std::uint64_t MaxSlotDelayUs = 0;
+};
@@ -0,0 +1,34 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "../../DSCoreTypes.h"
+#include "../../ECoreGamepad.h"
+#include "GamepadTriggersHaptic.h"
+
+/**
+ * @brief A single timed step of an adaptive trigger sequence.
+ *
+ * Keyframes are played in ascending TimeMs order. When a keyframe uses the
+ * Linear blend and both it and the previous keyframe share a resistance-type
+ * mode (0x01 continuous resistance or 0x22 bow), the parameters are
+ * interpolated between the two keyframes on every output tick. Any other
+ * combination snaps to the new effect when its time is reached.
+ */
+struct FGamepadTriggerKeyframe
+{
+	/**
+	 * Offset of this keyframe from the start of the sequence, in milliseconds.
+	 */
+	std::uint32_t TimeMs = 0;
+	/**
+	 * Effect applied once the keyframe is reached. Usually filled with the
+	 * FDualSenseTriggerComposer::Compose* helpers.
+	 */
+	FGamepadTriggersHaptic Effect;
+	/**
+	 * How the sequence moves from the previous keyframe into this one.
+	 */
+	EDSTriggerBlend Blend = EDSTriggerBlend::Step;
+};
@@ -0,0 +1,52 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Types/DSCoreTypes.h"
+
+/**
+ * @brief Settings of the audio-to-haptics processing stage.
+ *
+ * Game audio is split into a low band (body, rumble) and a band-pass band
+ * (texture). An envelope follower gates out low-level hum, transients are
+ * emphasised by comparing a fast and a slow envelope, and the result is
+ * routed to the left and right actuators through a 2x2 matrix.
+ */
+struct FHapticsDspConfig
+{
+	/** Enables the stage; when false, haptics are passed through untouched. */
+	bool bEnabled = false;
+
+	/** Cut-off of the low band, in Hz. */
+	float LowPassHz = 160.f;
+	/** Gain of the low band. */
+	float LowGain = 1.f;
+	/** Centre of the band-pass band, in Hz. */
+	float BandPassHz = 320.f;
+	/** Quality factor of the band-pass band. */
+	float BandPassQ = 0.9f;
+	/** Gain of the band-pass band. */
+	float BandGain = 0.6f;
+
+	/** Attack of the envelope follower, in milliseconds. */
+	float AttackMs = 2.f;
+	/** Release of the envelope follower, in milliseconds. */
+	float ReleaseMs = 60.f;
+	/** Envelope level below which the signal is faded out. */
+	float GateThreshold = 0.02f;
+
+	/** Extra gain applied to transients; 0 disables the emphasis. */
+	float TransientGain = 1.5f;
+	/** Time constant of the slow envelope transients are detected against, in milliseconds. */
+	float TransientWindowMs = 50.f;
+
+	/** Routing matrix from the processed input channels to the actuators. */
+	float LeftToLeft = 1.f;
+	float RightToLeft = 0.f;
+	float LeftToRight = 0.f;
+	float RightToRight = 1.f;
+
+	/** Gain applied after routing. */
+	float OutputGain = 1.f;
+};
@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Types/DSCoreTypes.h"
+
+/**
+ * @brief Latency settings of the USB haptics stream.
+ *
+ * The haptics queue is sized to MaxLatencyMs, so queued haptics can never lag
+ * the game by more than that. The writer steers the fill level towards
+ * TargetLatencyMs by dropping or repeating isolated frames, which absorbs the
+ * clock drift between the game and the audio device.
+ */
+struct FHapticsLatencyConfig
+{
+	/** Fill level the writer converges to, in milliseconds. */
+	std::uint32_t TargetLatencyMs = 15;
+	/** Capacity of the haptics queue, in milliseconds. Applied on the next audio device initialization. */
+	std::uint32_t MaxLatencyMs = 60;
+	/** Period requested from the audio backend, in milliseconds. Applied on the next audio device initialization. */
+	std::uint32_t PeriodMs = 5;
+	/**
+	 * Delay between a frame leaving the device callback and reaching the
+	 * actuators (backend buffering, USB transfer), in microseconds. Added
+	 * when scheduled playback converts host times to frames.
+	 */
+	std::uint32_t OutputLatencyUs = 0;
+};
+
+/**
+ * @brief Fill-level telemetry of the USB haptics stream. Counters are in
+ * frames and accumulate since the audio device was initialized.
+ */
+struct FHapticsBufferStats
+{
+	/** Frames the device asked for while the stream ran dry. */
+	std::uint64_t UnderrunFrames = 0;
+	/** Frames discarded because the haptics queue was full. */
+	std::uint64_t OverrunFrames = 0;
+	/** Frames dropped by the drift controller to lower the fill level. */
+	std::uint64_t DroppedFrames = 0;
+	/** Frames repeated by the drift controller to raise the fill level. */
+	std::uint64_t InsertedFrames = 0;
+	/** Frames queued at the time of the query. */
+	std::uint32_t FillFrames = 0;
+	/** Fill level the drift controller converges to. */
+	std::uint32_t TargetFrames = 0;
+};
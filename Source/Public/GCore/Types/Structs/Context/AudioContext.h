@@ -5,14 +5,20 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <span>
 #include <vector>
 
 #if GAMEPAD_CORE_HAS_AUDIO
 #include "miniaudio.h"
 #endif
 
+#include "GCore/Templates/TSpscBlockQueue.h"
+#include "GCore/Types/Structs/Config/HapticsLatency.h"
+#include "GCore/Utils/SoDefines.h"
 #include "GImplementations/Utils/GamepadAudio.h"
+#include "GImplementations/Utils/GamepadAudioEngine.h"
 
 using namespace FGamepadAudio;
 
@@ -35,6 +41,10 @@ struct FAudioDeviceContext
 		Close();
 	}
 
+	/**
+	 * Device callback: drains committed blocks from the haptics queue with a
+	 * single copy into pOutput and fills the remainder with silence.
+	 */
 	static void DataCallback(ma_device* pDevice, void* pOutput, const void* /*pInput*/, ma_uint32 frameCount)
 	{
 		auto pContext = static_cast<FAudioDeviceContext*>(pDevice->pUserData);
@@ -44,32 +54,47 @@ struct FAudioDeviceContext
 			return;
 		}
 
-		ma_uint32 framesAvailable = ma_pcm_rb_available_read(&pContext->RingBuffer);
-		ma_uint32 framesToRead = frameCount;
-
-		if (framesAvailable < framesToRead)
-		{
-			framesToRead = framesAvailable;
-		}
-
-		if (framesToRead > 0)
+		float* pOutputFloat = static_cast<float*>(pOutput);
+		const std::size_t Channels = static_cast<std::size_t>(pContext->NumChannels);
+		const std::size_t ElementsWanted = static_cast<std::size_t>(frameCount) * Channels;
+		std::size_t ElementsRead = 0;
+		while (ElementsRead < ElementsWanted)
 		{
-			void* pReadBuffer;
-			ma_uint32 readSize = framesToRead;
-			ma_pcm_rb_acquire_read(&pContext->RingBuffer, &readSize, &pReadBuffer);
+			if (!pContext->ReadBlock)
+			{
+				pContext->ReadBlock = pContext->Queue.AcquireRead(pContext->ReadBlockElements);
+				pContext->ReadOffset = 0;
+				if (!pContext->ReadBlock)
+				{
+					break;
+				}
+			}
 
-			std::memcpy(pOutput, pReadBuffer, readSize * pContext->NumChannels * sizeof(float));
+			const std::size_t Count = std::min(ElementsWanted - ElementsRead, pContext->ReadBlockElements - pContext->ReadOffset);
+			std::memcpy(&pOutputFloat[ElementsRead], &pContext->ReadBlock[pContext->ReadOffset], Count * sizeof(float));
+			pContext->Queue.ConsumeElements(Count);
+			ElementsRead += Count;
+			pContext->ReadOffset += Count;
 
-			ma_pcm_rb_commit_read(&pContext->RingBuffer, readSize);
+			if (pContext->ReadOffset == pContext->ReadBlockElements)
+			{
+				pContext->Queue.CommitRead();
+				pContext->ReadBlock = nullptr;
+			}
 		}
 
-		if (framesToRead < frameCount)
+		pContext->PublishClock(frameCount, ElementsRead / Channels);
+
+		if (ElementsRead < ElementsWanted)
 		{
-			float* pOutputFloat = static_cast<float*>(pOutput);
-			ma_uint32 framesMissing = frameCount - framesToRead;
+			std::memset(&pOutputFloat[ElementsRead], 0, (ElementsWanted - ElementsRead) * sizeof(float));
 
-			std::memset(&pOutputFloat[framesToRead * pContext->NumChannels], 0,
-			            framesMissing * pContext->NumChannels * sizeof(float));
+			// An empty queue means the producer is idle; only a stream that runs
+			// dry in the middle of a period is an underrun.
+			if (ElementsRead > 0)
+			{
+				pContext->UnderrunFrames.fetch_add((ElementsWanted - ElementsRead) / Channels, std::memory_order_relaxed);
+			}
 		}
 	}
 
@@ -78,7 +103,15 @@ struct FAudioDeviceContext
 		return InitializeWithDeviceId(nullptr, InSampleRate, InNumChannels);
 	}
 
-	bool InitializeWithDeviceId(const ma_device_id* pDeviceId, int InSampleRate = 48000, int InNumChannels = 4)
+	/**
+	 * Opens the playback device and starts it.
+	 *
+	 * @param pDeviceId The device to open, or nullptr for the default device.
+	 * @param pSharedContext A miniaudio context shared between devices, or
+	 *                       nullptr to use the one of FGamepadAudioEngine. The
+	 *                       device creates its own if that one failed.
+	 */
+	bool InitializeWithDeviceId(const ma_device_id* pDeviceId, int InSampleRate = 48000, int InNumChannels = 4, ma_context* pSharedContext = nullptr)
 	{
 		if (bInitialized)
 		{
@@ -95,15 +128,49 @@ struct FAudioDeviceContext
 			bHasDeviceId = false;
 		}
 
+		if (!pSharedContext)
+		{
+			pSharedContext = FGamepadAudioEngine::Get().GetAudioContext();
+		}
+
 		SampleRate = InSampleRate;
 		NumChannels = InNumChannels;
-		ma_uint32 bufferSizeInFrames = static_cast<ma_uint32>(SampleRate);
-
-		if (ma_pcm_rb_init(ma_format_f32, NumChannels, bufferSizeInFrames, nullptr, nullptr, &RingBuffer) != MA_SUCCESS)
+		WrittenFrames = 0;
+		ConsumedFrames = 0;
+		ClockSequence = 0;
+		UnderrunFrames = 0;
+		OverrunFrames = 0;
+		DroppedFrames = 0;
+		InsertedFrames = 0;
+		UpdateTargetFrames();
+
+		// One block per device period. The queue never holds more than
+		// MaxLatencyMs of haptics, so a producer running ahead can never make
+		// the output lag behind the game by more than that; blocks may be
+		// committed partially filled, hence twice the blocks strictly needed.
+		BlockFrames = PeriodFrames();
+		MaxQueuedFrames = std::max(MillisecondsToFrames(Latency.MaxLatencyMs), TargetFrames.load(std::memory_order_relaxed) + (2 * BlockFrames));
+		const std::size_t BlockCount = (2 * ((MaxQueuedFrames + BlockFrames - 1) / BlockFrames)) + 1;
+		if (!Queue.Initialize(BlockCount, static_cast<std::size_t>(BlockFrames) * NumChannels))
+		{
+			return false;
+		}
+		// Devices with speaker channels stage the speaker stream in stereo
+		// until the haptics writer interleaves it into the device blocks.
+		SpeakerQueue.Release();
+		if (NumChannels >= 4 && !SpeakerQueue.Initialize(BlockCount, static_cast<std::size_t>(BlockFrames) * 2))
 		{
+			Queue.Release();
 			return false;
 		}
-		bRingBufferInitialized = true;
+		SpeakerReadBlock = nullptr;
+		SpeakerReadElements = 0;
+		SpeakerReadOffset = 0;
+		WriteBlock = nullptr;
+		WriteBlockFrames = 0;
+		ReadBlock = nullptr;
+		ReadBlockElements = 0;
+		ReadOffset = 0;
 
 		ma_device_config Config = ma_device_config_init(ma_device_type_playback);
 		Config.playback.format = ma_format_f32;
@@ -112,20 +179,20 @@ struct FAudioDeviceContext
 		Config.sampleRate = SampleRate;
 		Config.dataCallback = DataCallback;
 		Config.pUserData = this;
-		// Config.periodSizeInMilliseconds = 10;
+		Config.periodSizeInFrames = BlockFrames;
 
-		if (ma_device_init(nullptr, &Config, &Device) != MA_SUCCESS)
+		if (ma_device_init(pSharedContext, &Config, &Device) != MA_SUCCESS)
 		{
-			ma_pcm_rb_uninit(&RingBuffer);
-			bRingBufferInitialized = false;
+			Queue.Release();
+			SpeakerQueue.Release();
 			return false;
 		}
 
 		if (ma_device_start(&Device) != MA_SUCCESS)
 		{
 			ma_device_uninit(&Device);
-			ma_pcm_rb_uninit(&RingBuffer);
-			bRingBufferInitialized = false;
+			Queue.Release();
+			SpeakerQueue.Release();
 			return false;
 		}
 
@@ -140,83 +207,454 @@ struct FAudioDeviceContext
 			ma_device_uninit(&Device);
 			bInitialized = false;
 		}
-		if (bRingBufferInitialized)
-		{
-			ma_pcm_rb_uninit(&RingBuffer);
-			bRingBufferInitialized = false;
-		}
+		Queue.Release();
+		SpeakerQueue.Release();
 	}
 
 	bool IsValid() const
 	{
-		return bInitialized && bRingBufferInitialized;
+		return bInitialized && Queue.IsInitialized();
+	}
+
+	/**
+	 * Updates the latency settings. The target and output latency take effect
+	 * immediately, through atomics read by the producer and scheduled
+	 * playback; the queue capacity and backend period are applied on the next
+	 * initialization.
+	 */
+	void SetLatency(const FHapticsLatencyConfig& InLatency)
+	{
+		Latency = InLatency;
+		UpdateTargetFrames();
+	}
+
+	const FHapticsLatencyConfig& GetLatency() const
+	{
+		return Latency;
+	}
+
+	/**
+	 * @return A snapshot of the fill level and the underrun/overrun counters.
+	 */
+	FHapticsBufferStats GetStats()
+	{
+		FHapticsBufferStats Stats;
+		Stats.UnderrunFrames = UnderrunFrames.load(std::memory_order_relaxed);
+		Stats.OverrunFrames = OverrunFrames.load(std::memory_order_relaxed);
+		Stats.DroppedFrames = DroppedFrames.load(std::memory_order_relaxed);
+		Stats.InsertedFrames = InsertedFrames.load(std::memory_order_relaxed);
+		Stats.FillFrames = GetQueuedFrames();
+		Stats.TargetFrames = TargetFrames.load(std::memory_order_relaxed);
+		return Stats;
 	}
 
 	ma_uint32 GetAvailableWriteFrames()
 	{
-		if (!bRingBufferInitialized)
+		if (!Queue.IsInitialized())
 		{
 			return 0;
 		}
-		return ma_pcm_rb_available_write(&RingBuffer);
+
+		const ma_uint32 Queued = GetQueuedFrames();
+		return Queued < MaxQueuedFrames ? MaxQueuedFrames - Queued : 0;
+	}
+
+	/**
+	 * @return The queue position of the next frame written, counting every
+	 * frame written since initialization. Producer clock of the queue.
+	 */
+	std::uint64_t GetWrittenFrames() const
+	{
+		return WrittenFrames.load(std::memory_order_acquire);
 	}
 
-	bool WriteHapticData(const std::vector<std::int16_t>& InterleavedData)
+	/**
+	 * Estimates when a queue frame reaches the actuators, from the device
+	 * clock published by the last callback and the frames queued ahead of it.
+	 * Assumes the queue does not run dry before that frame.
+	 *
+	 * @param QueueFrame A queue position, as returned by GetWrittenFrames.
+	 * @param OutHostTimeUs Receives the estimate, on the gc_time::now_us clock.
+	 * @return False until the device has run its first callback.
+	 */
+	bool EstimateHostTimeUs(std::uint64_t QueueFrame, std::uint64_t& OutHostTimeUs) const
 	{
-		if (!IsValid() || InterleavedData.empty())
+		std::uint64_t CallbackUs = 0;
+		std::uint64_t CallbackFrames = 0;
+		std::uint64_t Consumed = 0;
+		for (;;)
+		{
+			const std::uint32_t Sequence = ClockSequence.load(std::memory_order_acquire);
+			if (Sequence == 0)
+			{
+				return false;
+			}
+			if (Sequence & 1)
+			{
+				continue;
+			}
+
+			CallbackUs = ClockCallbackUs.load(std::memory_order_relaxed);
+			CallbackFrames = ClockCallbackFrames.load(std::memory_order_relaxed);
+			Consumed = ClockConsumedFrames.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (ClockSequence.load(std::memory_order_relaxed) == Sequence)
+			{
+				break;
+			}
+		}
+
+		// Frames handed to the last callback play first, then the queue
+		// from the position it stopped at.
+		const std::uint64_t FramesAhead = CallbackFrames + (QueueFrame > Consumed ? QueueFrame - Consumed : 0);
+		OutHostTimeUs = CallbackUs + ((FramesAhead * 1000000) / static_cast<std::uint64_t>(SampleRate)) + OutputLatencyUs.load(std::memory_order_relaxed);
+		return true;
+	}
+
+	/** @return The frames committed to the queue and not yet played. */
+	ma_uint32 GetQueuedFrames() const
+	{
+		return NumChannels > 0 ? static_cast<ma_uint32>(Queue.GetQueuedElements() / static_cast<std::size_t>(NumChannels)) : 0;
+	}
+
+	/**
+	 * Queues interleaved int16 stereo haptics (left, right) for playback.
+	 * Samples that do not fit in the queue are dropped.
+	 */
+	bool WriteHapticData(std::span<const std::int16_t> InterleavedData)
+	{
+		return WriteHapticFrames(InterleavedData.data(), static_cast<ma_uint32>(InterleavedData.size() / 2));
+	}
+
+	/**
+	 * Queues interleaved float stereo haptics (left, right) for playback,
+	 * without the round trip through int16.
+	 */
+	bool WriteHapticData(std::span<const float> InterleavedData)
+	{
+		return WriteHapticFrames(InterleavedData.data(), static_cast<ma_uint32>(InterleavedData.size() / 2));
+	}
+
+	/**
+	 * Stages interleaved int16 stereo speaker/headset PCM (left, right). The
+	 * samples play on channels 0/1 as the haptics writer consumes them, so
+	 * they stay aligned with the haptics written after them; keep the
+	 * haptics stream running (silence included) while the speaker plays.
+	 *
+	 * @return False if the device has no speaker channels or the stage is
+	 * full; samples that do not fit are dropped.
+	 */
+	bool WriteSpeakerData(std::span<const std::int16_t> InterleavedData)
+	{
+		return WriteSpeakerFrames(InterleavedData.data(), InterleavedData.size() / 2);
+	}
+
+	/**
+	 * Float variant of WriteSpeakerData.
+	 */
+	bool WriteSpeakerData(std::span<const float> InterleavedData)
+	{
+		return WriteSpeakerFrames(InterleavedData.data(), InterleavedData.size() / 2);
+	}
+
+	/**
+	 * Sets the digital gains of the speaker and haptic streams, applied when
+	 * the device blocks are built. Safe from any thread.
+	 */
+	void SetStreamGains(float InSpeakerGain, float InHapticsGain)
+	{
+		SpeakerGain.store(std::max(InSpeakerGain, 0.f), std::memory_order_relaxed);
+		HapticsGain.store(std::max(InHapticsGain, 0.f), std::memory_order_relaxed);
+	}
+
+private:
+	/**
+	 * Steers the fill level towards the latency target, then converts the
+	 * frames straight into the queue.
+	 *
+	 * When the queue drifts away from the target by more than a tolerance,
+	 * isolated frames are dropped (fill too high) or repeated (fill too low),
+	 * spread evenly over the block and limited to MaxCorrectionRatio of it so
+	 * the correction stays inaudible and imperceptible on the actuators.
+	 */
+	template<typename TSample>
+	bool WriteHapticFrames(const TSample* Samples, ma_uint32 FramesInput)
+	{
+		if (!IsValid() || FramesInput == 0)
 		{
 			return false;
 		}
-		ma_uint32 framesInput = static_cast<ma_uint32>(InterleavedData.size() / 2);
 
-		ma_uint32 framesAvailable = ma_pcm_rb_available_write(&RingBuffer);
-		ma_uint32 framesToWrite = (framesInput > framesAvailable) ? framesAvailable : framesInput;
+		// The frames queued ahead of this block are the latency it will play
+		// with, so that is the level compared against the target.
+		const ma_uint32 Fill = GetQueuedFrames();
+		const ma_uint32 Target = TargetFrames.load(std::memory_order_relaxed);
+		const ma_uint32 Tolerance = std::max(Target / 4, BlockFrames);
+		const ma_uint32 MaxCorrection = FramesInput / MaxCorrectionRatio;
 
-		if (framesToWrite == 0)
+		ma_uint32 Drop = 0;
+		ma_uint32 Insert = 0;
+		if (Fill > Target + Tolerance)
+		{
+			Drop = std::min(Fill - Target, MaxCorrection);
+		}
+		else if (Fill + Tolerance < Target)
 		{
-			return true;
+			Insert = std::min(Target - Fill, MaxCorrection);
 		}
 
-		void* pWriteBufferPtr;
-		if (ma_pcm_rb_acquire_write(&RingBuffer, &framesToWrite, &pWriteBufferPtr) != MA_SUCCESS)
+		const ma_uint32 Segments = std::max(Drop, Insert) + 1;
+		const ma_uint32 SegmentFrames = FramesInput / Segments;
+		ma_uint32 Offset = 0;
+		for (ma_uint32 Segment = 0; Segment < Segments; ++Segment)
 		{
-			return false;
+			ma_uint32 Count = (Segment + 1 == Segments) ? FramesInput - Offset : SegmentFrames;
+			if (Drop > 0 && Segment > 0)
+			{
+				++Offset;
+				--Count;
+				DroppedFrames.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			if (!CopyHapticFrames(&Samples[static_cast<std::size_t>(Offset) * 2], Count))
+			{
+				break;
+			}
+			Offset += Count;
+
+			if (Insert > 0 && Segment + 1 < Segments)
+			{
+				if (!CopyHapticFrames(&Samples[static_cast<std::size_t>(Offset - 1) * 2], 1))
+				{
+					break;
+				}
+				InsertedFrames.fetch_add(1, std::memory_order_relaxed);
+			}
 		}
 
-		float* pOutputBuffer = static_cast<float*>(pWriteBufferPtr);
-		constexpr float kNormalization = 1.0f / 32768.0f;
-		for (ma_uint32 i = 0; i < framesToWrite; i++)
+		// Publish the partially filled block too, so nothing written by this
+		// call waits for the next one.
+		FlushWriteBlock();
+		return true;
+	}
+
+	/**
+	 * Converts the frames straight into the current queue block, committing
+	 * each block as it fills up. Frames that would exceed the latency bound or
+	 * find no free block are counted as overrun.
+	 *
+	 * @return False if the queue was full.
+	 */
+	template<typename TSample>
+	bool CopyHapticFrames(const TSample* Samples, ma_uint32 Frames)
+	{
+		ma_uint32 FramesRemaining = Frames;
+		while (FramesRemaining > 0)
 		{
-			float LeftFloat = static_cast<float>(InterleavedData[i * 2]) * kNormalization;
-			float RightFloat = static_cast<float>(InterleavedData[(i * 2) + 1]) * kNormalization;
-			ma_uint32 baseIndex = i * NumChannels;
+			if (GetQueuedFrames() + WriteBlockFrames >= MaxQueuedFrames)
+			{
+				OverrunFrames.fetch_add(FramesRemaining, std::memory_order_relaxed);
+				return false;
+			}
 
-			if (NumChannels >= 4)
+			if (!WriteBlock)
 			{
-				pOutputBuffer[baseIndex + 0] = 0.f;
-				pOutputBuffer[baseIndex + 1] = 0.f;
-				pOutputBuffer[baseIndex + 2] = LeftFloat;
-				pOutputBuffer[baseIndex + 3] = RightFloat;
+				WriteBlock = Queue.AcquireWrite();
+				WriteBlockFrames = 0;
+				if (!WriteBlock)
+				{
+					OverrunFrames.fetch_add(FramesRemaining, std::memory_order_relaxed);
+					return false;
+				}
 			}
-			else
+
+			const ma_uint32 FramesToWrite = std::min({FramesRemaining, BlockFrames - WriteBlockFrames, MaxQueuedFrames - GetQueuedFrames() - WriteBlockFrames});
+			float* Destination = &WriteBlock[static_cast<std::size_t>(WriteBlockFrames) * NumChannels];
+			BuildDeviceFrames(Samples, Destination, FramesToWrite);
+			WriteBlockFrames += FramesToWrite;
+			WrittenFrames.fetch_add(FramesToWrite, std::memory_order_release);
+			if (WriteBlockFrames == BlockFrames)
 			{
-				pOutputBuffer[baseIndex + 0] = LeftFloat;
-				pOutputBuffer[baseIndex + 1] = RightFloat;
+				FlushWriteBlock();
 			}
+
+			Samples += static_cast<std::size_t>(FramesToWrite) * 2;
+			FramesRemaining -= FramesToWrite;
 		}
+		return true;
+	}
+
+	/**
+	 * Builds device frames from the haptics and the staged speaker stream,
+	 * one pass per contiguous run of speaker samples. Missing speaker
+	 * samples play as silence.
+	 */
+	template<typename TSample>
+	void BuildDeviceFrames(const TSample* Samples, float* Destination, ma_uint32 Frames)
+	{
+		const float SpeakerScale = SpeakerGain.load(std::memory_order_relaxed);
+		const float HapticsScale = HapticsGain.load(std::memory_order_relaxed);
+		std::size_t FramesRemaining = Frames;
+		while (FramesRemaining > 0)
+		{
+			std::size_t Count = FramesRemaining;
+			const float* Speaker = nullptr;
+			if (SpeakerQueue.IsInitialized())
+			{
+				if (!SpeakerReadBlock)
+				{
+					SpeakerReadBlock = SpeakerQueue.AcquireRead(SpeakerReadElements);
+					SpeakerReadOffset = 0;
+				}
+				if (SpeakerReadBlock)
+				{
+					Speaker = &SpeakerReadBlock[SpeakerReadOffset];
+					Count = std::min(Count, (SpeakerReadElements - SpeakerReadOffset) / 2);
+				}
+			}
+
+			InterleaveSpeakerHaptics(Speaker, Samples, Destination, Count, static_cast<std::uint32_t>(NumChannels), SpeakerScale, HapticsScale);
 
-		ma_pcm_rb_commit_write(&RingBuffer, framesToWrite);
+			if (Speaker)
+			{
+				SpeakerQueue.ConsumeElements(Count * 2);
+				SpeakerReadOffset += Count * 2;
+				if (SpeakerReadOffset == SpeakerReadElements)
+				{
+					SpeakerQueue.CommitRead();
+					SpeakerReadBlock = nullptr;
+				}
+			}
+
+			Samples += Count * 2;
+			Destination += Count * static_cast<std::size_t>(NumChannels);
+			FramesRemaining -= Count;
+		}
+	}
+
+	/**
+	 * Converts speaker samples into the stereo stage, bounded like the
+	 * haptics queue so the speaker can never lag by more than MaxLatencyMs.
+	 */
+	template<typename TSample>
+	bool WriteSpeakerFrames(const TSample* Samples, std::size_t Frames)
+	{
+		if (!IsValid() || !SpeakerQueue.IsInitialized())
+		{
+			return false;
+		}
+
+		while (Frames > 0)
+		{
+			const std::size_t Staged = SpeakerQueue.GetQueuedElements() / 2;
+			float* Block = Staged < MaxQueuedFrames ? SpeakerQueue.AcquireWrite() : nullptr;
+			if (!Block)
+			{
+				return false;
+			}
+
+			const std::size_t Count = std::min<std::size_t>({Frames, BlockFrames, MaxQueuedFrames - Staged});
+			InterleaveHaptics(Samples, Block, Count, 2);
+			SpeakerQueue.CommitWrite(Count * 2);
+			Samples += Count * 2;
+			Frames -= Count;
+		}
 		return true;
 	}
 
+	/**
+	 * Device callback: publishes the device clock read by EstimateHostTimeUs.
+	 * Single writer; ClockSequence is odd while the snapshot is written.
+	 */
+	void PublishClock(ma_uint32 FrameCount, std::size_t FramesRead)
+	{
+		ConsumedFrames += FramesRead;
+		const std::uint32_t Sequence = ClockSequence.load(std::memory_order_relaxed);
+		ClockSequence.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		ClockCallbackUs.store(gc_time::now_us(), std::memory_order_relaxed);
+		ClockCallbackFrames.store(FrameCount, std::memory_order_relaxed);
+		ClockConsumedFrames.store(ConsumedFrames, std::memory_order_relaxed);
+		ClockSequence.store(Sequence + 2, std::memory_order_release);
+	}
+
+	void FlushWriteBlock()
+	{
+		if (WriteBlock && WriteBlockFrames > 0)
+		{
+			Queue.CommitWrite(static_cast<std::size_t>(WriteBlockFrames) * NumChannels);
+			WriteBlock = nullptr;
+			WriteBlockFrames = 0;
+		}
+	}
+
+	ma_uint32 MillisecondsToFrames(std::uint32_t Milliseconds) const
+	{
+		return static_cast<ma_uint32>((static_cast<std::uint64_t>(SampleRate) * Milliseconds) / 1000);
+	}
+
+	ma_uint32 PeriodFrames() const
+	{
+		return std::max<ma_uint32>(MillisecondsToFrames(Latency.PeriodMs), 1);
+	}
+
+	void UpdateTargetFrames()
+	{
+		TargetFrames.store(MillisecondsToFrames(std::min(Latency.TargetLatencyMs, Latency.MaxLatencyMs)), std::memory_order_relaxed);
+		OutputLatencyUs.store(Latency.OutputLatencyUs, std::memory_order_relaxed);
+	}
+
+	/** At most one frame in MaxCorrectionRatio is dropped or repeated. */
+	static constexpr ma_uint32 MaxCorrectionRatio = 32;
+
 public:
 	ma_device Device;
-	ma_pcm_rb RingBuffer;
 	ma_device_id DeviceId;
 	int SampleRate = 48000;
 	int NumChannels = 4;
 	bool bInitialized = false;
-	bool bRingBufferInitialized = false;
 	bool bHasDeviceId = false;
+
+	/** Preallocated PCM blocks between the producer and the device callback. */
+	GamepadCore::TSpscBlockQueue<float> Queue;
+	ma_uint32 BlockFrames = 0;
+	ma_uint32 MaxQueuedFrames = 0;
+	/** Producer side: block being filled and frames already written to it. */
+	float* WriteBlock = nullptr;
+	ma_uint32 WriteBlockFrames = 0;
+	/** Consumer side: block being played and the read position inside it. */
+	const float* ReadBlock = nullptr;
+	std::size_t ReadBlockElements = 0;
+	std::size_t ReadOffset = 0;
+
+	/** Stereo speaker/headset stage, consumed by the haptics writer. */
+	GamepadCore::TSpscBlockQueue<float> SpeakerQueue;
+	const float* SpeakerReadBlock = nullptr;
+	std::size_t SpeakerReadElements = 0;
+	std::size_t SpeakerReadOffset = 0;
+	std::atomic<float> SpeakerGain = 1.f;
+	std::atomic<float> HapticsGain = 1.f;
+
+	/** Queue clocks: frames written by the producer, read by the device. */
+	std::atomic<std::uint64_t> WrittenFrames = 0;
+	std::uint64_t ConsumedFrames = 0;
+	/** Device clock snapshot of the last callback. */
+	std::atomic<std::uint32_t> ClockSequence = 0;
+	std::atomic<std::uint64_t> ClockCallbackUs = 0;
+	std::atomic<std::uint64_t> ClockCallbackFrames = 0;
+	std::atomic<std::uint64_t> ClockConsumedFrames = 0;
+
+	/**
+	 * Latency settings, only read by the thread configuring the device. The
+	 * values the producer and the device clock readers need live in the
+	 * atomics below.
+	 */
+	FHapticsLatencyConfig Latency;
+	std::atomic<ma_uint32> TargetFrames = 0;
+	std::atomic<std::uint32_t> OutputLatencyUs = 0;
+	std::atomic<std::uint64_t> UnderrunFrames = 0;
+	std::atomic<std::uint64_t> OverrunFrames = 0;
+	std::atomic<std::uint64_t> DroppedFrames = 0;
+	std::atomic<std::uint64_t> InsertedFrames = 0;
 };
 #endif
@@ -189,6 +189,11 @@ struct FDeviceContext
 	bool bEnableGesture = false;
 	bool bIsResetGyroscope = false;
 	bool bEnableAccelerometerAndGyroscope = false;
+	/**
+	 * When set, UpdateInput reads every report queued since the previous
+	 * call through IPlatformHardwareInfo::ReadAll instead of a single one.
+	 */
+	bool bDrainInputReports = false;
 	/**
 	 * A map representing the states of various buttons on a controller.
 	 *
@@ -237,6 +242,7 @@ struct FDeviceContext
  mutable gc_lock::mutex OutputMutex;
 
 	unsigned char* GetRawOutputBuffer() { return BufferOutput; }
+	unsigned char* GetLastOutputReport() { return LastOutputReport; }
 
 protected:
 	/**
@@ -277,6 +283,12 @@ private:
 	 * sufficient data handling capabilities.
 	 */
 	unsigned char BufferOutput[78] = {};
+	/**
+	 * Copy of the last output report composed for submission, excluding the
+	 * Bluetooth sequence byte and checksum. Used to detect whether a newly
+	 * composed report actually changed and needs to be written again.
+	 */
+	unsigned char LastOutputReport[78] = {};
 
 public:
 	FDeviceContext() = default;
@@ -294,12 +306,14 @@ public:
 			std::memcpy(BufferDS4, Other.BufferDS4, sizeof(BufferDS4));
 			std::memcpy(BufferAudio, Other.BufferAudio, sizeof(BufferAudio));
 			std::memcpy(BufferOutput, Other.BufferOutput, sizeof(BufferOutput));
+			std::memcpy(LastOutputReport, Other.LastOutputReport, sizeof(LastOutputReport));
 
 			// Auxiliary state variables
 			bEnableTouch = Other.bEnableTouch;
 			bEnableGesture = Other.bEnableGesture;
 			bIsResetGyroscope = Other.bIsResetGyroscope;
 			bEnableAccelerometerAndGyroscope = Other.bEnableAccelerometerAndGyroscope;
+			bDrainInputReports = Other.bDrainInputReports;
 
 			// Auxiliary status variables
 			Calibration = Other.Calibration;
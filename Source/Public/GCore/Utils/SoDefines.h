@@ -4,6 +4,8 @@
 #include GAMEPAD_CORE_EXTERNAL_SO_DEFINES
 #endif
 
+#include <cstdint>
+
 #if !defined(GAMEPAD_CORE_EMBEDDED)
 #include <chrono>
 #include <thread>
@@ -13,12 +15,26 @@
 // =====================
 // Tempo (tipo e helpers)
 // =====================
+#if defined(GAMEPAD_CORE_EMBEDDED)
+#define gc_now_us ::now_us
+#endif
+
 namespace gc_time {
 #if defined(GAMEPAD_CORE_EMBEDDED)
     using ms = unsigned int; // milissegundos nativo (evita <chrono>)
 #else
     using ms = std::chrono::milliseconds; // desktop/host
 #endif
+
+    // Relógio monotônico em microssegundos (base para sequências e agendamentos)
+    inline std::uint64_t now_us() {
+    #if defined(GAMEPAD_CORE_EMBEDDED)
+        return static_cast<std::uint64_t>(gc_now_us());
+    #else
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    #endif
+    }
 }
 
 // =====================
@@ -65,3 +81,19 @@ namespace gc_sync {
     #endif
     }
 }
+
+// =====================
+// SIMD (detecção em tempo de compilação)
+// =====================
+// Defina GAMEPAD_CORE_NO_SIMD para forçar os caminhos escalares.
+#if !defined(GAMEPAD_CORE_NO_SIMD)
+    #if defined(__AVX2__)
+        #define GAMEPAD_CORE_SIMD_AVX2 1
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define GAMEPAD_CORE_SIMD_SSE2 1
+    #endif
+    #if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+        #define GAMEPAD_CORE_SIMD_NEON 1
+    #endif
+#endif
@@ -142,6 +142,12 @@ public:
 	 * accelerometer (false) as the motion sensor.
 	 */
 	void EnableMotionSensor(bool bIsMotionSensor) override;
+	/**
+	 * Makes UpdateInput drain every queued report.
+	 *
+	 * @param bDrain True to drain, false to read one report per call.
+	 */
+	void EnableInputDrain(bool bDrain) override;
 	/**
 	 * @brief Retrieves a mutable device context associated with the object.
 	 *
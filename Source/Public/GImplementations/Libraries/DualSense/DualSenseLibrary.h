@@ -3,12 +3,23 @@
 // Description: Cross-platform library for DualSense and generic gamepad input support.
 // Targets: Windows, Linux, macOS.
 #pragma once
+#include "GCore/Interfaces/IInputReportSink.h"
 #include "GCore/Interfaces/Segregations/IGamepadAudioHaptics.h"
 #include "GCore/Interfaces/Segregations/IGamepadTrigger.h"
+#include "GCore/Templates/TGenericHardwareInfo.h"
 #include "GCore/Types/DSCoreTypes.h"
 #include "GCore/Types/ECoreGamepad.h"
 #include "GCore/Types/Structs/Context/DeviceContext.h"
 #include "GImplementations/Libraries/Base/SonyGamepadAbstract.h"
+#include "GImplementations/Utils/GamepadHapticBank.h"
+#include "GImplementations/Utils/GamepadHapticsDsp.h"
+#include "GImplementations/Utils/GamepadHapticsEncoder.h"
+#include "GImplementations/Utils/GamepadHapticsMixer.h"
+#include "GImplementations/Utils/GamepadLinkScheduler.h"
+#include "GImplementations/Utils/GamepadOutput.h"
+#include "GImplementations/Utils/GamepadSensors.h"
+#include "GImplementations/Utils/GamepadTriggerSequence.h"
+#include <atomic>
 
 /**
  * @class FDualSenseLibrary
@@ -35,7 +46,9 @@
  */
 class FDualSenseLibrary : public SonyGamepadAbstract,
                           public IGamepadTrigger,
-                          public IGamepadAudioHaptics
+                          public IGamepadAudioHaptics,
+                          private IGamepadLinkSink,
+                          private IInputReportSink
 {
 
 public:
@@ -43,6 +56,12 @@ public:
 	    : AudioVibrationSequence(0)
 	{}
 
+	/**
+	 * @brief Stops the link scheduler and the audio engine registration
+	 * before any member is destroyed.
+	 */
+	virtual ~FDualSenseLibrary() override;
+
 	/**
 	 * @brief Retrieves the current gamepad trigger implementation.
 	 *
@@ -98,6 +117,26 @@ public:
 	 * the current state or input from the system.
 	 */
 	virtual void UpdateOutput() override;
+	/**
+	 * @brief Composes the DualSense output report for a batched write.
+	 *
+	 * Advances the trigger sequences and builds the report into the device
+	 * buffer. The caller must hold the OutputMutex of the device context.
+	 *
+	 * @return True if the report changed since the last one composed.
+	 */
+	virtual bool PrepareOutput() override;
+	/**
+	 * @brief Moves the Bluetooth initialization forward once the enable
+	 * report had time to be processed by the controller.
+	 *
+	 * @return True once the gamepad is ready for regular output.
+	 */
+	virtual bool AdvanceInitialization() override;
+	/**
+	 * @return True if the gamepad finished its initialization.
+	 */
+	virtual bool IsReady() const override;
 	/**
 	 * @brief Initializes the DualSense library with the specified device context.
 	 *
@@ -295,6 +334,29 @@ public:
 	virtual void
 	SetCustomTrigger(const EDSGamepadHand& Hand,
 	                 const std::vector<std::uint8_t>& HexBytes) override;
+	/**
+	 * @brief Allocation-free variant of SetCustomTrigger taking exactly 10
+	 * bytes.
+	 */
+	virtual void
+	SetCustomTrigger(const EDSGamepadHand& Hand,
+	                 std::span<const std::uint8_t, 10> HexBytes) override;
+	/**
+	 * @brief Plays a timed sequence of adaptive trigger effects.
+	 *
+	 * The keyframes are evaluated by UpdateOutput against the library clock,
+	 * right before the output report is built.
+	 *
+	 * @param Hand The controller hand (left, right or both) that plays the
+	 * sequence.
+	 * @param Keyframes The timed keyframes of the sequence.
+	 * @param bLoop Whether the sequence restarts after its last keyframe.
+	 */
+	virtual void PlayTriggerSequence(const EDSGamepadHand& Hand,
+	                                 const std::vector<FGamepadTriggerKeyframe>& Keyframes,
+	                                 bool bLoop) override;
+	virtual void StopTriggerSequence(const EDSGamepadHand& Hand) override;
+	virtual bool IsTriggerSequencePlaying(const EDSGamepadHand& Hand) override;
 
 	/**
 	 * Sets the LED player indicator effects based on the desired player LED
@@ -386,8 +448,274 @@ public:
 	 */
 	virtual void AudioHapticUpdate(const std::vector<std::uint8_t>& Data) override;
 	virtual void AudioHapticUpdate(const std::vector<std::int16_t>& AudioData) override;
+	/**
+	 * @brief Sends one 64-byte Bluetooth haptic packet without allocating.
+	 */
+	virtual void AudioHapticUpdate(std::span<const std::uint8_t, 64> Data) override;
+	/**
+	 * @brief Queues interleaved stereo 16-bit samples to the USB haptic
+	 * channels without allocating.
+	 */
+	virtual void AudioHapticUpdate(std::span<const std::int16_t> AudioData) override;
+	/**
+	 * @brief Queues interleaved stereo float samples to the USB haptic
+	 * channels without converting them to int16 first.
+	 */
+	virtual void AudioHapticUpdate(std::span<const float> AudioData) override;
+	/**
+	 * @brief Stages interleaved stereo 16-bit speaker samples for the USB
+	 * audio device.
+	 */
+	virtual void AudioSpeakerUpdate(std::span<const std::int16_t> AudioData) override;
+	/**
+	 * @brief Stages interleaved stereo float speaker samples for the USB
+	 * audio device.
+	 */
+	virtual void AudioSpeakerUpdate(std::span<const float> AudioData) override;
+	/**
+	 * @brief Forwards the speaker and haptic gains to the USB audio device
+	 * context.
+	 */
+	virtual void SetAudioStreamGains(float SpeakerGain, float HapticsGain) override;
+	/**
+	 * @brief Sets the rate of the PCM given to the int16 and float haptic
+	 * updates. Over Bluetooth it configures the built-in encoder. Applied by
+	 * the audio thread at the start of its next block.
+	 */
+	virtual void SetHapticsSampleRate(std::uint32_t SampleRate) override;
+	/**
+	 * @brief Configures the processing stage in front of the haptic outputs.
+	 * Applied by the audio thread at the start of its next block.
+	 */
+	virtual void SetHapticsDsp(const FHapticsDspConfig& Config) override;
+	/**
+	 * @brief Forwards the latency settings to the USB audio device context.
+	 */
+	virtual void SetHapticsLatency(const FHapticsLatencyConfig& Latency) override;
+	/**
+	 * @brief Reads the telemetry of the USB haptics queue.
+	 */
+	virtual bool GetHapticsStats(FHapticsBufferStats& OutStats) override;
+	/**
+	 * @brief Returns the mixer layering the haptic voices of this controller.
+	 */
+	virtual FGamepadHapticsMixer* GetHapticsMixer() override { return &HapticsMixer; }
+	/**
+	 * @brief Renders the haptics mixer into the USB queue or the Bluetooth
+	 * encoder.
+	 */
+	virtual void RenderHapticsMixer(std::uint32_t Frames) override;
+	/**
+	 * @brief Plays a bank clip through the mixer (USB) or as pre-encoded
+	 * packets (Bluetooth).
+	 */
+	virtual bool PlayHapticClip(const FHapticClipView& Clip, std::uint8_t Priority, float Gain) override;
+	/**
+	 * @brief Plays a mixer clip starting at a host time.
+	 */
+	virtual std::int32_t ScheduleHapticClip(std::span<const float> Interleaved, std::uint64_t HostTimeUs, std::uint8_t Priority, float Gain) override;
+	/**
+	 * @brief Creates a mixer stream starting at a host time.
+	 */
+	virtual std::int32_t ScheduleHapticStream(std::uint64_t HostTimeUs, std::uint8_t Priority, float Gain) override;
+	/**
+	 * @brief Starts pacing Bluetooth haptics and output reports from the link
+	 * scheduler thread.
+	 */
+	virtual bool EnableBluetoothLink(const FBluetoothLinkConfig& Config) override;
+	/**
+	 * @brief Stops the link scheduler thread.
+	 */
+	virtual void DisableBluetoothLink() override;
+	/**
+	 * @brief Reads the counters of the link scheduler.
+	 */
+	virtual bool GetBluetoothLinkStats(FBluetoothLinkStats& OutStats) override;
+	/**
+	 * @brief Stops the link scheduler before the device handle is released.
+	 */
+	virtual void ShutdownLibrary() override;
+
+protected:
+	/**
+	 * @brief Initialize writing the Bluetooth enable report through the
+	 * given hardware policy.
+	 */
+	template<typename THardware>
+	bool InitializeWith(THardware& Hardware, const FDeviceContext& Context)
+	{
+		SetDeviceContexts(Context);
+		FDeviceContext* DSContext = GetMutableDeviceContext();
+		if (DSContext->ConnectionType != EDSDeviceConnection::Bluetooth)
+		{
+			FinishUsbInitialization();
+			return true;
+		}
+
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(DSContext->OutputMutex);
+		ComposeEnableReport(DSContext);
+		Hardware.Write(DSContext);
+		return true;
+	}
+	/**
+	 * @brief UpdateInput reading through the given hardware policy.
+	 */
+	template<typename THardware>
+	void ReadInput(THardware& Hardware)
+	{
+		FDeviceContext* Context = GetMutableDeviceContext();
+		if (!Context || !Context->IsConnected)
+		{
+			return;
+		}
+
+		if (!Context->bDrainInputReports)
+		{
+			Hardware.Read(Context);
+		}
+		else if (GamepadCore::PolicyReadAll(Hardware, Context, this) == 0)
+		{
+			// Nothing queued: the published input is still current.
+			return;
+		}
+		DecodeInput(Context);
+	}
+	/**
+	 * @brief UpdateOutput writing through the given hardware policy.
+	 */
+	template<typename THardware>
+	void WriteOutput(THardware& Hardware)
+	{
+		FDeviceContext* Context = GetMutableDeviceContext();
+		if (!Context)
+		{
+			return;
+		}
+
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(Context->OutputMutex);
+		if (!BeginOutputUpdate(Context))
+		{
+			return;
+		}
+
+		ComposeOutputReport(Context);
+		Hardware.Write(Context);
+	}
+	/**
+	 * @brief SendOutputReport writing through the given hardware policy.
+	 */
+	template<typename THardware>
+	void WriteOutputReport(THardware& Hardware)
+	{
+		FDeviceContext* Context = GetMutableDeviceContext();
+		if (!Context || !Context->IsConnected)
+		{
+			return;
+		}
+
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(Context->OutputMutex);
+		ComposeOutputReport(Context);
+		Hardware.Write(Context);
+	}
+	/**
+	 * @brief SendHapticPacket submitting through the given hardware policy.
+	 */
+	template<typename THardware>
+	void WriteHapticPacket(THardware& Hardware, std::span<const std::uint8_t, 64> Packet)
+	{
+		FDeviceContext* Context = GetMutableDeviceContext();
+		if (!Context || !Context->IsConnected || !IsReady())
+		{
+			return;
+		}
+
+		ComposeHapticPacket(Context, Packet);
+		FGamepadOutput::SendAudioHapticAdvanced(Context, Hardware);
+	}
+	/**
+	 * @brief Decodes the report read into the device buffer and publishes it
+	 * as the current input. Motion is the average of the reports drained
+	 * since the previous decode, if any.
+	 */
+	void DecodeInput(FDeviceContext* Context);
+	/**
+	 * @brief Checks whether UpdateOutput writes a report itself, advancing
+	 * the initialization on the way. While the link scheduler runs, the
+	 * report is requested from it instead. The caller must hold the
+	 * OutputMutex of the device context.
+	 */
+	bool BeginOutputUpdate(FDeviceContext* Context);
+	/**
+	 * @brief Advances the trigger sequences and composes the output report.
+	 * The caller must hold the OutputMutex of the device context.
+	 *
+	 * @return True if the report changed since the last one composed.
+	 */
+	bool ComposeOutputReport(FDeviceContext* Context);
+	/**
+	 * @brief Copies a haptic packet into the audio report of the device.
+	 */
+	void ComposeHapticPacket(FDeviceContext* Context, std::span<const std::uint8_t, 64> Packet);
+	/**
+	 * @brief Unregisters the gamepad from the audio engine and stops the link
+	 * scheduler, so no other thread calls into it once the handle closes.
+	 */
+	void StopHapticsThreads();
 
 private:
+	/**
+	 * @brief Link scheduler: writes one haptic packet as a Bluetooth audio
+	 * report.
+	 */
+	virtual void SendHapticPacket(std::span<const std::uint8_t, 64> Packet) override;
+	/**
+	 * @brief Link scheduler: composes and writes the output report.
+	 */
+	virtual void SendOutputReport() override;
+	/**
+	 * @brief Input drain: accumulates the motion of a queued report and
+	 * handles its mute button edge.
+	 */
+	virtual void OnInputReport(FDeviceContext* Context) override;
+	/**
+	 * @brief Toggles the microphone when the mute button goes down.
+	 */
+	void UpdateMuteState(FDeviceContext* Context, bool bMute);
+	/**
+	 * @brief Runs PCM haptics through the processing stage, if enabled, and
+	 * submits them.
+	 */
+	template<typename TSample>
+	void ProcessHaptics(std::span<const TSample> AudioData);
+	/**
+	 * @brief Sends PCM haptics to the Bluetooth encoder or the USB queue.
+	 */
+	template<typename TSample>
+	void SubmitHaptics(FDeviceContext* Context, std::span<const TSample> AudioData);
+	/**
+	 * @brief Stages PCM for the speaker channels of the USB audio device.
+	 */
+	template<typename TSample>
+	void SubmitSpeaker(std::span<const TSample> AudioData);
+	/**
+	 * @brief Sends the pre-encoded Bluetooth packets due after Frames more
+	 * frames of haptics time.
+	 *
+	 * @return False if no Bluetooth clip is playing.
+	 */
+	bool AdvanceBluetoothClip(std::uint32_t Frames);
+	/**
+	 * @brief Converts a host time into the mixer frame that reaches the
+	 * actuators at that time.
+	 */
+	std::uint64_t HostTimeToMixerFrame(std::uint64_t HostTimeUs);
+	/**
+	 * @brief Audio thread: applies the haptics settings requested since the
+	 * previous block, so the encoder, mixer and processing stage are only
+	 * reconfigured between blocks.
+	 */
+	void ApplyHapticsSettings();
+
 	/**
 	 * @variable AudioVibrationSequence
 	 * @brief Represents the identifier for a sequence of audio-guided vibrations.
@@ -404,4 +732,91 @@ private:
 	 * environments or devices.
 	 */
 	std::uint8_t AudioVibrationSequence;
+	/**
+	 * @brief Mute button state of the previous input report, to toggle the
+	 * microphone on press only.
+	 */
+	bool bLastMuteState = false;
+	/**
+	 * @brief Motion of the reports drained since the previous decode.
+	 */
+	FGamepadSensors::FMotionAccumulator DrainedMotion;
+	/**
+	 * @brief Timed trigger effects evaluated on every output update. Guarded
+	 * by the OutputMutex of the device context.
+	 */
+	FGamepadTriggerSequencer TriggerSequencer;
+	/**
+	 * @brief Converts PCM haptics into Bluetooth packets.
+	 */
+	FGamepadHapticsEncoder HapticsEncoder;
+	/**
+	 * @brief Shapes game audio for the actuators ahead of the encoder and the
+	 * USB queue.
+	 */
+	FGamepadHapticsDsp HapticsDsp;
+	/**
+	 * @brief Layers the haptic voices of this controller.
+	 */
+	FGamepadHapticsMixer HapticsMixer;
+	/**
+	 * @brief Haptics settings requested by the API thread, picked up by
+	 * ApplyHapticsSettings. The mutex only guards the processing settings
+	 * copy and is taken by the audio thread only when a change is pending.
+	 */
+	gc_lock::mutex HapticsSettingsMutex;
+	FHapticsDspConfig RequestedHapticsDsp;
+	std::atomic<std::uint32_t> RequestedHapticsSampleRate = 48000;
+	std::atomic<bool> bHapticsSettingsPending = false;
+	/**
+	 * @brief Bluetooth clip handed from PlayHapticClip to the audio thread.
+	 * Single writer; BluetoothClipSequence is odd while it is being written.
+	 */
+	std::atomic<std::uint32_t> BluetoothClipSequence = 0;
+	std::atomic<const std::uint8_t*> BluetoothClipRequest = nullptr;
+	std::atomic<std::size_t> BluetoothClipRequestPackets = 0;
+	/**
+	 * @brief Bluetooth clip state owned by the audio thread.
+	 */
+	std::uint32_t BluetoothClipAccepted = 0;
+	const std::uint8_t* BluetoothClipPackets = nullptr;
+	std::size_t BluetoothClipRemaining = 0;
+	std::uint64_t BluetoothClipDebt = 0;
+	/**
+	 * @brief Current stage of the initialization. Written by whichever thread
+	 * advances it (registry tick or output path).
+	 */
+	std::atomic<EDSInitializationState> InitializationState = EDSInitializationState::Uninitialized;
+	/**
+	 * @brief Monotonic time, in microseconds, after which the Bluetooth enable
+	 * report is considered applied.
+	 */
+	std::uint64_t EnableReportDeadlineUs = 0;
+	/**
+	 * @brief Delay the controller needs after the Bluetooth enable report.
+	 */
+	static constexpr std::uint64_t EnableReportDelayUs = 50000;
+	/**
+	 * @brief Builds the Bluetooth enable report and starts waiting for the
+	 * controller to apply it. The caller must hold the OutputMutex.
+	 */
+	void ComposeEnableReport(FDeviceContext* DSContext);
+	/**
+	 * @brief AdvanceInitialization for callers holding the OutputMutex.
+	 */
+	bool AdvanceInitializationLocked();
+	/**
+	 * @brief Sets up a USB controller and sends its first output report.
+	 */
+	void FinishUsbInitialization();
+	/**
+	 * @brief Sets up the Bluetooth feature and audio report headers once the
+	 * enable report was applied. The caller must hold the OutputMutex.
+	 */
+	void FinishBluetoothInitialization();
+	/**
+	 * @brief Bluetooth pacing thread. Declared last so it is stopped before
+	 * any state it calls back into is destroyed.
+	 */
+	FGamepadLinkScheduler LinkScheduler;
 };
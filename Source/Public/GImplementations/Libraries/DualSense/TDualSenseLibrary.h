@@ -0,0 +1,67 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GImplementations/Libraries/DualSense/DualSenseLibrary.h"
+
+namespace GamepadCore
+{
+	/**
+	 * @class TDualSenseLibrary
+	 * @brief DualSense library bound at compile time to a hardware policy.
+	 *
+	 * Input, output and haptic reports go straight to the policy instead of
+	 * through the IPlatformHardwareInfo singleton, so its Read and Write can
+	 * be inlined into the decode and compose paths. The policy must outlive
+	 * the library.
+	 */
+	template<typename THardwarePolicy>
+	class TDualSenseLibrary final : public FDualSenseLibrary
+	{
+	public:
+		explicit TDualSenseLibrary(THardwarePolicy& InHardware)
+		    : Hardware(InHardware)
+		{}
+
+		/** Stops the haptics threads while SendOutputReport still reaches Hardware. */
+		virtual ~TDualSenseLibrary() override
+		{
+			StopHapticsThreads();
+		}
+
+		virtual bool Initialize(const FDeviceContext& Context) override
+		{
+			return InitializeWith(Hardware, Context);
+		}
+
+		virtual void UpdateInput(float /*Delta*/) override
+		{
+			ReadInput(Hardware);
+		}
+
+		virtual void UpdateOutput() override
+		{
+			WriteOutput(Hardware);
+		}
+
+		virtual void ShutdownLibrary() override
+		{
+			StopHapticsThreads();
+			Hardware.InvalidateHandle(GetMutableDeviceContext());
+		}
+
+	private:
+		virtual void SendHapticPacket(std::span<const std::uint8_t, 64> Packet) override
+		{
+			WriteHapticPacket(Hardware, Packet);
+		}
+
+		virtual void SendOutputReport() override
+		{
+			WriteOutputReport(Hardware);
+		}
+
+		THardwarePolicy& Hardware;
+	};
+} // namespace GamepadCore
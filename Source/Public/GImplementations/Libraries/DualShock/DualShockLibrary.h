@@ -2,11 +2,16 @@
 // Created for: WindowsDualShock_ds5w - Plugin to support DualShock controller
 // on Windows. Planned Release Year: 2025
 #pragma once
+#include "GCore/Interfaces/IInputReportSink.h"
+#include "GCore/Templates/TGenericHardwareInfo.h"
 #include "GCore/Types/DSCoreTypes.h"
 #include "GCore/Types/Structs/Context/DeviceContext.h"
 #include "GImplementations/Libraries/Base/SonyGamepadAbstract.h"
+#include "GImplementations/Utils/GamepadOutput.h"
+#include "GImplementations/Utils/GamepadSensors.h"
 
-class FDualShockLibrary : public SonyGamepadAbstract
+class FDualShockLibrary : public SonyGamepadAbstract,
+                          private IInputReportSink
 {
 
 public:
@@ -40,6 +45,14 @@ public:
 	 * device.
 	 */
 	virtual void UpdateOutput() override;
+	/**
+	 * @brief Composes the DualShock output report for a batched write.
+	 *
+	 * The caller must hold the OutputMutex of the device context.
+	 *
+	 * @return True if the report changed since the last one composed.
+	 */
+	virtual bool PrepareOutput() override;
 
 	/**
 	 * @brief Updates the input state for a DualShock device.
@@ -87,4 +100,54 @@ public:
 	 * Optional, defaults to 0.
 	 */
 	virtual void SetVibration(uint8_t LeftRumble, uint8_t RightRumble) override;
+
+protected:
+	/**
+	 * @brief UpdateInput reading through the given hardware policy.
+	 */
+	template<typename THardware>
+	void ReadInput(THardware& Hardware)
+	{
+		FDeviceContext* Context = GetMutableDeviceContext();
+		if (!Context->bDrainInputReports)
+		{
+			Hardware.Read(Context);
+		}
+		else if (GamepadCore::PolicyReadAll(Hardware, Context, this) == 0)
+		{
+			// Nothing queued: the published input is still current.
+			return;
+		}
+		DecodeInput(Context);
+	}
+	/**
+	 * @brief UpdateOutput writing through the given hardware policy.
+	 */
+	template<typename THardware>
+	void WriteOutput(THardware& Hardware)
+	{
+		FDeviceContext* Context = GetMutableDeviceContext();
+		if (!Context->IsConnected)
+		{
+			return;
+		}
+
+		FGamepadOutput::OutputDualShock(Context, Hardware);
+	}
+	/**
+	 * @brief Decodes the report read into the device buffer and publishes it
+	 * as the current input. Motion is the average of the reports drained
+	 * since the previous decode, if any.
+	 */
+	void DecodeInput(FDeviceContext* Context);
+
+private:
+	/**
+	 * @brief Input drain: accumulates the motion of a queued report.
+	 */
+	virtual void OnInputReport(FDeviceContext* Context) override;
+	/**
+	 * @brief Motion of the reports drained since the previous decode.
+	 */
+	FGamepadSensors::FMotionAccumulator DrainedMotion;
 };
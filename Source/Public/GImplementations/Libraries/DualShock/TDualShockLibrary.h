@@ -0,0 +1,43 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GImplementations/Libraries/DualShock/DualShockLibrary.h"
+
+namespace GamepadCore
+{
+	/**
+	 * @class TDualShockLibrary
+	 * @brief DualShock 4 library bound at compile time to a hardware policy.
+	 *
+	 * Reports go straight to the policy instead of through the
+	 * IPlatformHardwareInfo singleton. The policy must outlive the library.
+	 */
+	template<typename THardwarePolicy>
+	class TDualShockLibrary final : public FDualShockLibrary
+	{
+	public:
+		explicit TDualShockLibrary(THardwarePolicy& InHardware)
+		    : Hardware(InHardware)
+		{}
+
+		virtual void UpdateInput(float /*Delta*/) override
+		{
+			ReadInput(Hardware);
+		}
+
+		virtual void UpdateOutput() override
+		{
+			WriteOutput(Hardware);
+		}
+
+		virtual void ShutdownLibrary() override
+		{
+			Hardware.InvalidateHandle(GetMutableDeviceContext());
+		}
+
+	private:
+		THardwarePolicy& Hardware;
+	};
+} // namespace GamepadCore
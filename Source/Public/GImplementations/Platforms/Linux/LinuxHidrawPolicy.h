@@ -0,0 +1,105 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Interfaces/IInputReportSink.h"
+#include "GCore/Types/ECoreGamepad.h"
+#include "GCore/Types/Structs/Context/DeviceContext.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) && !defined(GAMEPAD_CORE_EMBEDDED)
+
+/**
+ * @class FLinuxHidrawPolicy
+ * @brief Hardware policy for Linux that talks to the kernel hidraw driver
+ * directly, without hidapi.
+ *
+ * Controllers are found through sysfs and opened as non-blocking
+ * /dev/hidraw nodes, driven by one io_uring. hidraw cannot complete a read
+ * without parking a kernel worker in it, so every controller keeps a
+ * multishot poll armed instead: Read only touches a controller whose poll
+ * completed, draining its queue with non-blocking reads in arrival order
+ * and keeping the newest report; ReadAll hands every one of them to its
+ * sink. Writes are submitted
+ * asynchronously, the reports of a WriteBatch with a single system call. A
+ * controller has at most one write in flight so its reports stay in order;
+ * the others wait in a short queue where a newer output report replaces a
+ * waiting one.
+ *
+ * Where io_uring is unavailable (old kernels, seccomp filters) the policy
+ * falls back to non-blocking read and write calls, and exposes its handles
+ * to the reader engine through GetPollDescriptor.
+ *
+ * AddFakeDevice registers a controller backed by packet-mode pipes, so the
+ * whole path can run in CI without hardware.
+ */
+class FLinuxHidrawPolicy
+{
+public:
+	/** Maximum number of controllers open at once. */
+	static constexpr std::size_t MaxDevices = 16;
+	/** Writes queued per controller, including the one in flight. */
+	static constexpr std::size_t WritesPerDevice = 4;
+
+	/**
+	 * Test ends of a fake controller, owned by the caller. Input reports
+	 * written to InputFd are read as if sent by the controller; the output
+	 * reports sent to it can be read from OutputFd, one per read call.
+	 */
+	struct FFakeDeviceEnds
+	{
+		int InputFd = -1;
+		int OutputFd = -1;
+	};
+
+	FLinuxHidrawPolicy();
+	~FLinuxHidrawPolicy();
+	FLinuxHidrawPolicy(const FLinuxHidrawPolicy&) = delete;
+	FLinuxHidrawPolicy& operator=(const FLinuxHidrawPolicy&) = delete;
+
+	void Read(FDeviceContext* Context);
+	std::size_t ReadAll(FDeviceContext* Context, IInputReportSink* Sink);
+	void Write(FDeviceContext* Context);
+	void WriteBatch(std::span<FDeviceContext*> Contexts);
+	void Detect(std::vector<FDeviceContext>& Devices);
+	bool CreateHandle(FDeviceContext* Context);
+	void InvalidateHandle(FDeviceContext* Context);
+	void ProcessAudioHaptic(FDeviceContext* Context);
+	void InitializeAudioDevice(FDeviceContext* Context);
+	std::intptr_t GetPollDescriptor(FDeviceContext* Context);
+
+	/** @return True if I/O goes through io_uring rather than the fallback. */
+	bool IsUsingIoUring() const;
+
+	/**
+	 * Enables or disables the sysfs scan of Detect, e.g. so tests only see
+	 * fake controllers. Enabled by default.
+	 */
+	void SetSysfsScan(bool bEnabled);
+
+	/**
+	 * Registers a pipe-backed controller reported by Detect under Path.
+	 *
+	 * @return False if Path is already registered or the pipes could not be
+	 * created.
+	 */
+	bool AddFakeDevice(const std::string& Path, EDSDeviceType DeviceType, EDSDeviceConnection ConnectionType, FFakeDeviceEnds& OutEnds);
+
+	/**
+	 * Stops reporting a fake controller. A handle still open on it reads end
+	 * of file once the caller closes InputFd, which disconnects it.
+	 */
+	void RemoveFakeDevice(const std::string& Path);
+
+private:
+	struct FImpl;
+	std::unique_ptr<FImpl> Impl;
+};
+
+#endif
@@ -38,6 +38,376 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include "GCore/Utils/SoDefines.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if GAMEPAD_CORE_SIMD_AVX2 || GAMEPAD_CORE_SIMD_SSE2
+#include <immintrin.h>
+#elif GAMEPAD_CORE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 namespace FGamepadAudio
 {
-}
+	/**
+	 * Scale applied to signed 16-bit samples to map them into [-1, 1).
+	 */
+	inline constexpr float Int16ToFloat = 1.0f / 32768.0f;
+
+	/**
+	 * Writes one stereo frame into an output frame of OutChannels floats.
+	 *
+	 * Devices with four or more channels carry the speaker on channels 0/1 and
+	 * the haptic actuators on 2/3; the speaker channels and any extra channel
+	 * are cleared. Two-channel devices receive the haptics directly.
+	 */
+	inline void WriteHapticFrame(float Left, float Right, float* OutFrame, std::uint32_t OutChannels)
+	{
+		if (OutChannels >= 4)
+		{
+			OutFrame[0] = 0.f;
+			OutFrame[1] = 0.f;
+			OutFrame[2] = Left;
+			OutFrame[3] = Right;
+			for (std::uint32_t Channel = 4; Channel < OutChannels; ++Channel)
+			{
+				OutFrame[Channel] = 0.f;
+			}
+			return;
+		}
+
+		OutFrame[0] = Left;
+		if (OutChannels > 1)
+		{
+			OutFrame[1] = Right;
+		}
+	}
+
+	/**
+	 * Converts interleaved int16 stereo haptics into the float device layout.
+	 *
+	 * The two-channel and four-channel layouts are vectorised (AVX2, SSE2 or
+	 * NEON, picked at compile time); any other channel count and the loop
+	 * tails use the scalar path.
+	 *
+	 * @param In Interleaved stereo samples, 2 * Frames values.
+	 * @param Out Destination region, OutChannels * Frames floats.
+	 * @param Frames The number of stereo frames to convert.
+	 * @param OutChannels The channel count of the output device.
+	 */
+	inline void InterleaveHaptics(const std::int16_t* In, float* Out, std::size_t Frames, std::uint32_t OutChannels)
+	{
+		std::size_t Frame = 0;
+		if (OutChannels == 2)
+		{
+#if GAMEPAD_CORE_SIMD_AVX2
+			const __m256 Scale = _mm256_set1_ps(Int16ToFloat);
+			for (; Frame + 4 <= Frames; Frame += 4)
+			{
+				const __m128i Samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&In[Frame * 2]));
+				const __m256 Values = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(Samples)), Scale);
+				_mm256_storeu_ps(&Out[Frame * 2], Values);
+			}
+#elif GAMEPAD_CORE_SIMD_SSE2
+			const __m128 Scale = _mm_set1_ps(Int16ToFloat);
+			for (; Frame + 4 <= Frames; Frame += 4)
+			{
+				const __m128i Samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&In[Frame * 2]));
+				const __m128i Low = _mm_srai_epi32(_mm_unpacklo_epi16(Samples, Samples), 16);
+				const __m128i High = _mm_srai_epi32(_mm_unpackhi_epi16(Samples, Samples), 16);
+				_mm_storeu_ps(&Out[Frame * 2], _mm_mul_ps(_mm_cvtepi32_ps(Low), Scale));
+				_mm_storeu_ps(&Out[(Frame * 2) + 4], _mm_mul_ps(_mm_cvtepi32_ps(High), Scale));
+			}
+#elif GAMEPAD_CORE_SIMD_NEON
+			for (; Frame + 4 <= Frames; Frame += 4)
+			{
+				const int16x8_t Samples = vld1q_s16(&In[Frame * 2]);
+				vst1q_f32(&Out[Frame * 2], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(Samples))), Int16ToFloat));
+				vst1q_f32(&Out[(Frame * 2) + 4], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(Samples))), Int16ToFloat));
+			}
+#endif
+		}
+		else if (OutChannels == 4)
+		{
+#if GAMEPAD_CORE_SIMD_SSE2
+			const __m128 Scale = _mm_set1_ps(Int16ToFloat);
+			const __m128 Zero = _mm_setzero_ps();
+			for (; Frame + 4 <= Frames; Frame += 4)
+			{
+				const __m128i Samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&In[Frame * 2]));
+				const __m128 Low = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Samples, Samples), 16)), Scale);
+				const __m128 High = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Samples, Samples), 16)), Scale);
+				float* OutFrames = &Out[Frame * 4];
+				_mm_storeu_ps(&OutFrames[0], _mm_movelh_ps(Zero, Low));
+				_mm_storeu_ps(&OutFrames[4], _mm_movehl_ps(Low, Zero));
+				_mm_storeu_ps(&OutFrames[8], _mm_movelh_ps(Zero, High));
+				_mm_storeu_ps(&OutFrames[12], _mm_movehl_ps(High, Zero));
+			}
+#elif GAMEPAD_CORE_SIMD_NEON
+			const float32x2_t Zero = vdup_n_f32(0.f);
+			for (; Frame + 4 <= Frames; Frame += 4)
+			{
+				const int16x8_t Samples = vld1q_s16(&In[Frame * 2]);
+				const float32x4_t Low = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(Samples))), Int16ToFloat);
+				const float32x4_t High = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(Samples))), Int16ToFloat);
+				float* OutFrames = &Out[Frame * 4];
+				vst1q_f32(&OutFrames[0], vcombine_f32(Zero, vget_low_f32(Low)));
+				vst1q_f32(&OutFrames[4], vcombine_f32(Zero, vget_high_f32(Low)));
+				vst1q_f32(&OutFrames[8], vcombine_f32(Zero, vget_low_f32(High)));
+				vst1q_f32(&OutFrames[12], vcombine_f32(Zero, vget_high_f32(High)));
+			}
+#endif
+		}
+
+		for (; Frame < Frames; ++Frame)
+		{
+			const float Left = static_cast<float>(In[Frame * 2]) * Int16ToFloat;
+			const float Right = static_cast<float>(In[(Frame * 2) + 1]) * Int16ToFloat;
+			WriteHapticFrame(Left, Right, &Out[Frame * OutChannels], OutChannels);
+		}
+	}
+
+	/**
+	 * Copies interleaved float stereo haptics into the float device layout,
+	 * for engines that already mix in float.
+	 *
+	 * @param In Interleaved stereo samples, 2 * Frames values.
+	 * @param Out Destination region, OutChannels * Frames floats.
+	 * @param Frames The number of stereo frames to copy.
+	 * @param OutChannels The channel count of the output device.
+	 */
+	inline void InterleaveHaptics(const float* In, float* Out, std::size_t Frames, std::uint32_t OutChannels)
+	{
+		if (OutChannels == 2)
+		{
+			std::memcpy(Out, In, Frames * 2 * sizeof(float));
+			return;
+		}
+
+		std::size_t Frame = 0;
+		if (OutChannels == 4)
+		{
+#if GAMEPAD_CORE_SIMD_SSE2
+			const __m128 Zero = _mm_setzero_ps();
+			for (; Frame + 2 <= Frames; Frame += 2)
+			{
+				const __m128 Samples = _mm_loadu_ps(&In[Frame * 2]);
+				_mm_storeu_ps(&Out[Frame * 4], _mm_movelh_ps(Zero, Samples));
+				_mm_storeu_ps(&Out[(Frame * 4) + 4], _mm_movehl_ps(Samples, Zero));
+			}
+#elif GAMEPAD_CORE_SIMD_NEON
+			const float32x2_t Zero = vdup_n_f32(0.f);
+			for (; Frame + 2 <= Frames; Frame += 2)
+			{
+				const float32x4_t Samples = vld1q_f32(&In[Frame * 2]);
+				vst1q_f32(&Out[Frame * 4], vcombine_f32(Zero, vget_low_f32(Samples)));
+				vst1q_f32(&Out[(Frame * 4) + 4], vcombine_f32(Zero, vget_high_f32(Samples)));
+			}
+#endif
+		}
+
+		for (; Frame < Frames; ++Frame)
+		{
+			WriteHapticFrame(In[Frame * 2], In[(Frame * 2) + 1], &Out[Frame * OutChannels], OutChannels);
+		}
+	}
+
+	/**
+	 * Builds device frames from a speaker stream and a haptics stream in a
+	 * single pass: speaker on channels 0/1, haptics on 2/3, any extra channel
+	 * cleared. Two-channel devices receive the haptics only.
+	 *
+	 * The four-channel layout is vectorised (SSE2 or NEON); other channel
+	 * counts and the loop tails use the scalar path.
+	 *
+	 * @param Speaker Interleaved stereo float speaker samples, 2 * Frames
+	 *                values, or nullptr for silence.
+	 * @param Haptics Interleaved stereo haptics (int16 or float), 2 * Frames
+	 *                values.
+	 * @param Out Destination region, OutChannels * Frames floats.
+	 * @param Frames The number of frames to build.
+	 * @param OutChannels The channel count of the output device.
+	 * @param SpeakerGain Gain applied to the speaker samples.
+	 * @param HapticsGain Gain applied to the haptic samples.
+	 */
+	template<typename TSample>
+	inline void InterleaveSpeakerHaptics(const float* Speaker, const TSample* Haptics, float* Out, std::size_t Frames, std::uint32_t OutChannels, float SpeakerGain, float HapticsGain)
+	{
+		static_assert(std::is_same_v<TSample, std::int16_t> || std::is_same_v<TSample, float>, "Haptics must be int16 or float samples.");
+		const float HapticsScale = std::is_same_v<TSample, std::int16_t> ? HapticsGain * Int16ToFloat : HapticsGain;
+
+		std::size_t Frame = 0;
+		if (OutChannels == 4)
+		{
+#if GAMEPAD_CORE_SIMD_SSE2
+			const __m128 SpeakerScaleVector = _mm_set1_ps(SpeakerGain);
+			const __m128 HapticsScaleVector = _mm_set1_ps(HapticsScale);
+			for (; Frame + 2 <= Frames; Frame += 2)
+			{
+				__m128 HapticsPair;
+				if constexpr (std::is_same_v<TSample, std::int16_t>)
+				{
+					const __m128i Samples = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Haptics[Frame * 2]));
+					HapticsPair = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Samples, Samples), 16));
+				}
+				else
+				{
+					HapticsPair = _mm_loadu_ps(&Haptics[Frame * 2]);
+				}
+				HapticsPair = _mm_mul_ps(HapticsPair, HapticsScaleVector);
+				const __m128 SpeakerPair = Speaker ? _mm_mul_ps(_mm_loadu_ps(&Speaker[Frame * 2]), SpeakerScaleVector) : _mm_setzero_ps();
+				_mm_storeu_ps(&Out[Frame * 4], _mm_movelh_ps(SpeakerPair, HapticsPair));
+				_mm_storeu_ps(&Out[(Frame * 4) + 4], _mm_movehl_ps(HapticsPair, SpeakerPair));
+			}
+#elif GAMEPAD_CORE_SIMD_NEON
+			for (; Frame + 2 <= Frames; Frame += 2)
+			{
+				float32x4_t HapticsPair;
+				if constexpr (std::is_same_v<TSample, std::int16_t>)
+				{
+					HapticsPair = vcvtq_f32_s32(vmovl_s16(vld1_s16(&Haptics[Frame * 2])));
+				}
+				else
+				{
+					HapticsPair = vld1q_f32(&Haptics[Frame * 2]);
+				}
+				HapticsPair = vmulq_n_f32(HapticsPair, HapticsScale);
+				const float32x4_t SpeakerPair = Speaker ? vmulq_n_f32(vld1q_f32(&Speaker[Frame * 2]), SpeakerGain) : vdupq_n_f32(0.f);
+				vst1q_f32(&Out[Frame * 4], vcombine_f32(vget_low_f32(SpeakerPair), vget_low_f32(HapticsPair)));
+				vst1q_f32(&Out[(Frame * 4) + 4], vcombine_f32(vget_high_f32(SpeakerPair), vget_high_f32(HapticsPair)));
+			}
+#endif
+		}
+
+		for (; Frame < Frames; ++Frame)
+		{
+			float* OutFrame = &Out[Frame * OutChannels];
+			const float Left = static_cast<float>(Haptics[Frame * 2]) * HapticsScale;
+			const float Right = static_cast<float>(Haptics[(Frame * 2) + 1]) * HapticsScale;
+			WriteHapticFrame(Left, Right, OutFrame, OutChannels);
+			if (OutChannels >= 4 && Speaker)
+			{
+				OutFrame[0] = Speaker[Frame * 2] * SpeakerGain;
+				OutFrame[1] = Speaker[(Frame * 2) + 1] * SpeakerGain;
+			}
+		}
+	}
+
+	/**
+	 * Accumulates Src into Dst with a gain ramped linearly from StartGain to
+	 * EndGain across the buffer, so gain changes never produce steps.
+	 *
+	 * @param Dst Accumulation buffer.
+	 * @param Src Samples to be added.
+	 * @param Count The number of samples (not frames).
+	 * @param StartGain Gain applied to the first sample.
+	 * @param EndGain Gain reached after the last sample.
+	 */
+	inline void MixAddRamp(float* Dst, const float* Src, std::size_t Count, float StartGain, float EndGain)
+	{
+		if (Count == 0)
+		{
+			return;
+		}
+
+		const float Delta = (EndGain - StartGain) / static_cast<float>(Count);
+		std::size_t Index = 0;
+#if GAMEPAD_CORE_SIMD_SSE2
+		__m128 Gain = _mm_add_ps(_mm_set1_ps(StartGain), _mm_mul_ps(_mm_set_ps(3.f, 2.f, 1.f, 0.f), _mm_set1_ps(Delta)));
+		const __m128 Step = _mm_set1_ps(Delta * 4.f);
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			_mm_storeu_ps(&Dst[Index], _mm_add_ps(_mm_loadu_ps(&Dst[Index]), _mm_mul_ps(_mm_loadu_ps(&Src[Index]), Gain)));
+			Gain = _mm_add_ps(Gain, Step);
+		}
+#elif GAMEPAD_CORE_SIMD_NEON
+		const float Lanes[4] = {0.f, 1.f, 2.f, 3.f};
+		float32x4_t Gain = vmlaq_n_f32(vdupq_n_f32(StartGain), vld1q_f32(Lanes), Delta);
+		const float32x4_t Step = vdupq_n_f32(Delta * 4.f);
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			vst1q_f32(&Dst[Index], vmlaq_f32(vld1q_f32(&Dst[Index]), vld1q_f32(&Src[Index]), Gain));
+			Gain = vaddq_f32(Gain, Step);
+		}
+#endif
+		for (; Index < Count; ++Index)
+		{
+			Dst[Index] += Src[Index] * (StartGain + (Delta * static_cast<float>(Index)));
+		}
+	}
+
+	/**
+	 * Scales Data in place with a gain ramped linearly from StartGain to
+	 * EndGain across the buffer.
+	 */
+	inline void ScaleRamp(float* Data, std::size_t Count, float StartGain, float EndGain)
+	{
+		if (Count == 0)
+		{
+			return;
+		}
+
+		const float Delta = (EndGain - StartGain) / static_cast<float>(Count);
+		std::size_t Index = 0;
+#if GAMEPAD_CORE_SIMD_SSE2
+		__m128 Gain = _mm_add_ps(_mm_set1_ps(StartGain), _mm_mul_ps(_mm_set_ps(3.f, 2.f, 1.f, 0.f), _mm_set1_ps(Delta)));
+		const __m128 Step = _mm_set1_ps(Delta * 4.f);
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			_mm_storeu_ps(&Data[Index], _mm_mul_ps(_mm_loadu_ps(&Data[Index]), Gain));
+			Gain = _mm_add_ps(Gain, Step);
+		}
+#elif GAMEPAD_CORE_SIMD_NEON
+		const float Lanes[4] = {0.f, 1.f, 2.f, 3.f};
+		float32x4_t Gain = vmlaq_n_f32(vdupq_n_f32(StartGain), vld1q_f32(Lanes), Delta);
+		const float32x4_t Step = vdupq_n_f32(Delta * 4.f);
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			vst1q_f32(&Data[Index], vmulq_f32(vld1q_f32(&Data[Index]), Gain));
+			Gain = vaddq_f32(Gain, Step);
+		}
+#endif
+		for (; Index < Count; ++Index)
+		{
+			Data[Index] *= StartGain + (Delta * static_cast<float>(Index));
+		}
+	}
+
+	/**
+	 * @return The largest absolute sample value of the buffer.
+	 */
+	inline float PeakAbs(const float* Data, std::size_t Count)
+	{
+		float Peak = 0.f;
+		std::size_t Index = 0;
+#if GAMEPAD_CORE_SIMD_SSE2
+		const __m128 SignMask = _mm_set1_ps(-0.f);
+		__m128 PeakVector = _mm_setzero_ps();
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			PeakVector = _mm_max_ps(PeakVector, _mm_andnot_ps(SignMask, _mm_loadu_ps(&Data[Index])));
+		}
+		alignas(16) float Lanes[4];
+		_mm_store_ps(Lanes, PeakVector);
+		Peak = std::max(std::max(Lanes[0], Lanes[1]), std::max(Lanes[2], Lanes[3]));
+#elif GAMEPAD_CORE_SIMD_NEON
+		float32x4_t PeakVector = vdupq_n_f32(0.f);
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			PeakVector = vmaxq_f32(PeakVector, vabsq_f32(vld1q_f32(&Data[Index])));
+		}
+		const float32x2_t Pair = vpmax_f32(vget_low_f32(PeakVector), vget_high_f32(PeakVector));
+		Peak = std::max(vget_lane_f32(Pair, 0), vget_lane_f32(Pair, 1));
+#endif
+		for (; Index < Count; ++Index)
+		{
+			Peak = std::max(Peak, std::fabs(Data[Index]));
+		}
+		return Peak;
+	}
+} // namespace FGamepadAudio
@@ -0,0 +1,123 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Interfaces/Segregations/IGamepadAudioHaptics.h"
+#include "GCore/Utils/SoDefines.h"
+#include "GImplementations/Utils/GamepadAudio.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class FGamepadAudioEngine
+ * @brief Renders the haptics of every controller from a single thread on a
+ * common clock.
+ *
+ * Registered controllers are rendered one after the other on every engine
+ * period: each one advances by the same number of frames of the shared
+ * clock, so effects started together stay in step across pads, and all
+ * mixing and DSP runs on one warm thread instead of one per audio device.
+ * The device callbacks are left with a plain copy out of their queues.
+ *
+ * The engine also owns the miniaudio context shared by every controller
+ * audio device, so backends are enumerated and initialized once.
+ *
+ * Controllers can be added and removed at any time; the render thread reads
+ * the slots without locking, and only the caller removing a controller waits
+ * for the pass in flight to end. On embedded targets, where no thread is
+ * spawned, Tick is driven by the caller instead.
+ */
+class FGamepadAudioEngine
+{
+public:
+	/** Maximum number of controllers rendered by the engine. */
+	static constexpr std::size_t MaxSources = 16;
+	/** Frames a pass may catch up after a stall; older frames are skipped. */
+	static constexpr std::uint32_t MaxCatchUpPeriods = 4;
+
+	/** @return The process-wide engine. */
+	static FGamepadAudioEngine& Get();
+
+	FGamepadAudioEngine(const FGamepadAudioEngine&) = delete;
+	FGamepadAudioEngine& operator=(const FGamepadAudioEngine&) = delete;
+	~FGamepadAudioEngine();
+
+	/**
+	 * Starts the render thread.
+	 *
+	 * @param InSampleRate Rate of the shared clock; must match the haptics
+	 *                     sample rate of the controllers.
+	 * @param InPeriodMs Time between two render passes.
+	 * @return False if already running or threads are unavailable.
+	 */
+	bool Start(std::uint32_t InSampleRate = 48000, std::uint32_t InPeriodMs = 5);
+
+	/** Stops and joins the render thread. */
+	void Stop();
+
+	/** @return True while the render thread runs. */
+	bool IsRunning() const { return bRunning.load(std::memory_order_acquire); }
+
+	/**
+	 * Registers a controller whose haptics mixer is rendered on every pass.
+	 *
+	 * @return False if the controller is already registered or every slot is
+	 * taken.
+	 */
+	bool AddSource(IGamepadAudioHaptics* Source);
+
+	/**
+	 * Unregisters a controller. On return the render thread no longer uses
+	 * it, so it can be destroyed.
+	 */
+	void RemoveSource(IGamepadAudioHaptics* Source);
+
+	/**
+	 * Renders every registered controller up to the current clock time.
+	 * Called by the render thread; on targets without threads, call it
+	 * periodically instead of Start.
+	 */
+	void Tick();
+
+	/** @return Frames rendered on the shared clock since Start. */
+	std::uint64_t GetClockFrames() const { return ClockFrames.load(std::memory_order_acquire); }
+
+#if GAMEPAD_CORE_HAS_AUDIO
+	/**
+	 * Returns the miniaudio context shared by the controller audio devices,
+	 * initializing it on first use. Pass it to
+	 * FAudioDeviceContext::InitializeWithDeviceId.
+	 *
+	 * @return The context, or nullptr if the backend failed to initialize.
+	 */
+	ma_context* GetAudioContext();
+#endif
+
+private:
+	FGamepadAudioEngine() = default;
+
+	void Run();
+	void WaitForPass();
+
+	std::array<std::atomic<IGamepadAudioHaptics*>, MaxSources> Sources = {};
+	/** Odd while a pass is rendering; RemoveSource waits for it to move on. */
+	std::atomic<std::uint64_t> PassSequence = 0;
+	std::atomic<std::uint64_t> ClockFrames = 0;
+	std::atomic<bool> bRunning = false;
+	std::uint32_t SampleRate = 48000;
+	std::uint32_t PeriodMs = 5;
+	std::uint64_t StartUs = 0;
+
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	std::thread Thread;
+#endif
+
+#if GAMEPAD_CORE_HAS_AUDIO
+	gc_lock::mutex ContextMutex;
+	ma_context AudioContext;
+	bool bContextInitialized = false;
+#endif
+};
@@ -0,0 +1,128 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief On-disk layout of a compiled haptic clip bank.
+ *
+ * A bank starts with FHapticBankHeader, followed by the clip index
+ * (ClipCount FHapticBankEntry records sorted by Id) and the clip payloads.
+ * Every payload starts on a 64-byte boundary so it can be read in place from
+ * a mapping. All values are little-endian.
+ *
+ * Each clip carries two payloads:
+ * - PCM: interleaved stereo floats at the bank sample rate, played by the
+ *   haptics mixer on the USB path;
+ * - packets: 64-byte Bluetooth haptic packets, already encoded at 3 kHz.
+ */
+namespace FHapticBankFormat
+{
+	/** "GCHB" read as a little-endian integer. */
+	inline constexpr std::uint32_t Magic = 0x42484347;
+	inline constexpr std::uint32_t Version = 1;
+	/** Alignment of every payload in the file. */
+	inline constexpr std::uint64_t PayloadAlignment = 64;
+	/** Size in bytes of a pre-encoded Bluetooth packet. */
+	inline constexpr std::uint32_t PacketSize = 64;
+
+	struct FHapticBankHeader
+	{
+		std::uint32_t Magic = FHapticBankFormat::Magic;
+		std::uint32_t Version = FHapticBankFormat::Version;
+		/** Rate of the PCM payloads, in Hz. */
+		std::uint32_t SampleRate = 48000;
+		std::uint32_t ClipCount = 0;
+		/** Offset of the clip index from the start of the file. */
+		std::uint64_t IndexOffset = 0;
+	};
+
+	struct FHapticBankEntry
+	{
+		std::uint32_t Id = 0;
+		/** Stereo frames of the PCM payload. */
+		std::uint32_t Frames = 0;
+		std::uint64_t PcmOffset = 0;
+		std::uint32_t PacketCount = 0;
+		std::uint32_t Reserved = 0;
+		std::uint64_t PacketOffset = 0;
+	};
+
+	static_assert(sizeof(FHapticBankHeader) == 24, "The bank header layout is part of the file format.");
+	static_assert(sizeof(FHapticBankEntry) == 32, "The bank entry layout is part of the file format.");
+} // namespace FHapticBankFormat
+
+/**
+ * @brief A clip of a mapped bank. The spans point into the mapping and stay
+ * valid while the bank is open.
+ */
+struct FHapticClipView
+{
+	/** Interleaved stereo floats at SampleRate, for the USB path. */
+	std::span<const float> Pcm;
+	/** Concatenated 64-byte Bluetooth packets. */
+	std::span<const std::uint8_t> Packets;
+	std::uint32_t SampleRate = 0;
+
+	bool IsValid() const { return !Pcm.empty() || !Packets.empty(); }
+};
+
+/**
+ * @class FGamepadHapticBank
+ * @brief Read-only, memory-mapped bank of pre-compiled haptic clips.
+ *
+ * Banks are produced offline by the HapticBankCompiler tool. Opening a bank
+ * maps the file and validates the index once; clips are then looked up by Id
+ * with a binary search and played straight from the mapping, with no decode
+ * and no allocation.
+ */
+class FGamepadHapticBank
+{
+public:
+	FGamepadHapticBank() = default;
+	~FGamepadHapticBank();
+
+	FGamepadHapticBank(const FGamepadHapticBank&) = delete;
+	FGamepadHapticBank& operator=(const FGamepadHapticBank&) = delete;
+
+	/**
+	 * Maps a bank file. Any bank already open is closed first.
+	 *
+	 * @param Path Path of the bank file (UTF-8).
+	 * @return False if the file cannot be mapped or is not a valid bank.
+	 */
+	bool Open(const char* Path);
+
+	/** Unmaps the bank. Clips still playing from it must be stopped first. */
+	void Close();
+
+	bool IsOpen() const { return Data != nullptr; }
+
+	/** @return The rate of the PCM payloads, in Hz. */
+	std::uint32_t GetSampleRate() const;
+
+	/** @return The number of clips in the bank. */
+	std::uint32_t GetClipCount() const;
+
+	/**
+	 * Looks up a clip.
+	 *
+	 * @param Id The clip identifier given at compile time.
+	 * @return The clip, or an invalid view if the bank has no such clip.
+	 */
+	FHapticClipView FindClip(std::uint32_t Id) const;
+
+private:
+	bool Validate() const;
+
+	const std::uint8_t* Data = nullptr;
+	std::size_t Size = 0;
+#if defined(_WIN32)
+	void* FileHandle = nullptr;
+	void* MappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,223 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Types/Structs/Config/HapticsDsp.h"
+#include "GImplementations/Utils/GamepadAudio.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+
+/**
+ * @class FGamepadHapticsDsp
+ * @brief Real-time audio-to-haptics processing of interleaved stereo floats.
+ *
+ * The band split runs both channels of both bands through one 4-lane biquad
+ * cascade (left low, right low, left band, right band), so every frame costs
+ * two vector biquad steps on SSE2/NEON. The envelope, transient and routing
+ * stages follow per frame. Blocks are processed in place and all state is
+ * held inline, so processing never allocates.
+ *
+ * It works at any sample rate and runs ahead of both the USB queue and the
+ * Bluetooth encoder.
+ */
+class FGamepadHapticsDsp
+{
+public:
+	FGamepadHapticsDsp()
+	{
+		Configure(FHapticsDspConfig(), 48000);
+	}
+
+	/**
+	 * Applies new settings and clears the filter and envelope state. Must be
+	 * called from the thread that runs Process.
+	 *
+	 * @param InConfig The processing settings.
+	 * @param InSampleRate The rate of the processed samples, in Hz.
+	 */
+	void Configure(const FHapticsDspConfig& InConfig, std::uint32_t InSampleRate)
+	{
+		Config = InConfig;
+		SampleRate = std::max<std::uint32_t>(InSampleRate, 1);
+
+		const double Nyquist = 0.45 * static_cast<double>(SampleRate);
+		const double LowCutoff = std::clamp(static_cast<double>(Config.LowPassHz), 10.0, Nyquist);
+		const double BandCentre = std::clamp(static_cast<double>(Config.BandPassHz), 10.0, Nyquist);
+		const double BandQ = std::max(static_cast<double>(Config.BandPassQ), 0.1);
+
+		// Fourth-order Butterworth low band; the band-pass band runs through
+		// the same section twice for steeper skirts.
+		for (std::size_t Lane = 0; Lane < 2; ++Lane)
+		{
+			Sections[0].SetLowPass(Lane, LowCutoff, SampleRate, 0.54119610);
+			Sections[1].SetLowPass(Lane, LowCutoff, SampleRate, 1.30656296);
+			Sections[0].SetBandPass(Lane + 2, BandCentre, SampleRate, BandQ);
+			Sections[1].SetBandPass(Lane + 2, BandCentre, SampleRate, BandQ);
+		}
+
+		AttackCoefficient = SmoothingCoefficient(Config.AttackMs);
+		ReleaseCoefficient = SmoothingCoefficient(Config.ReleaseMs);
+		SlowCoefficient = SmoothingCoefficient(Config.TransientWindowMs);
+		Reset();
+	}
+
+	/** @return The settings currently applied. */
+	const FHapticsDspConfig& GetConfig() const { return Config; }
+
+	/** @return True if Process alters the signal. */
+	bool IsEnabled() const { return Config.bEnabled; }
+
+	/** Clears the filter and envelope state. */
+	void Reset()
+	{
+		for (FBiquad4& Section : Sections)
+		{
+			Section.Reset();
+		}
+		for (std::size_t Channel = 0; Channel < 2; ++Channel)
+		{
+			Envelope[Channel] = 0.f;
+			SlowEnvelope[Channel] = 0.f;
+		}
+	}
+
+	/**
+	 * Processes interleaved stereo floats in place.
+	 *
+	 * @param Interleaved Samples (left, right), 2 * Frames values.
+	 * @param Frames The number of stereo frames.
+	 */
+	void Process(float* Interleaved, std::size_t Frames)
+	{
+		if (!Config.bEnabled)
+		{
+			return;
+		}
+
+		for (std::size_t Frame = 0; Frame < Frames; ++Frame)
+		{
+			float* Samples = &Interleaved[Frame * 2];
+			alignas(16) float Lanes[4] = {Samples[0], Samples[1], Samples[0], Samples[1]};
+			Sections[0].Process(Lanes);
+			Sections[1].Process(Lanes);
+
+			float Shaped[2];
+			for (std::size_t Channel = 0; Channel < 2; ++Channel)
+			{
+				const float Low = Lanes[Channel];
+				const float Band = Lanes[Channel + 2];
+				const float Level = std::fabs(Low) + std::fabs(Band);
+
+				const float Coefficient = Level > Envelope[Channel] ? AttackCoefficient : ReleaseCoefficient;
+				Envelope[Channel] += (Level - Envelope[Channel]) * Coefficient;
+				SlowEnvelope[Channel] += (Level - SlowEnvelope[Channel]) * SlowCoefficient;
+
+				// A transient is the part of the fast envelope above the slow
+				// one, relative to the fast envelope: 0 when steady, towards 1
+				// on a sharp onset.
+				const float Onset = std::max(Envelope[Channel] - SlowEnvelope[Channel], 0.f) / (Envelope[Channel] + 1e-6f);
+				const float Gate = std::min(Envelope[Channel] / (Config.GateThreshold + 1e-6f), 1.f);
+				const float Emphasis = 1.f + (Config.TransientGain * Onset);
+
+				Shaped[Channel] = ((Low * Config.LowGain) + (Band * Config.BandGain)) * Emphasis * Gate;
+			}
+
+			Samples[0] = ((Shaped[0] * Config.LeftToLeft) + (Shaped[1] * Config.RightToLeft)) * Config.OutputGain;
+			Samples[1] = ((Shaped[0] * Config.LeftToRight) + (Shaped[1] * Config.RightToRight)) * Config.OutputGain;
+		}
+	}
+
+private:
+	/**
+	 * Four independent transposed direct form II biquads evaluated together.
+	 */
+	struct FBiquad4
+	{
+		alignas(16) float B0[4] = {1.f, 1.f, 1.f, 1.f};
+		alignas(16) float B1[4] = {};
+		alignas(16) float B2[4] = {};
+		alignas(16) float A1[4] = {};
+		alignas(16) float A2[4] = {};
+		alignas(16) float Z1[4] = {};
+		alignas(16) float Z2[4] = {};
+
+		void SetLowPass(std::size_t Lane, double Cutoff, std::uint32_t Rate, double Q)
+		{
+			const double Omega = 2.0 * std::numbers::pi * Cutoff / static_cast<double>(Rate);
+			const double Alpha = std::sin(Omega) / (2.0 * Q);
+			const double CosOmega = std::cos(Omega);
+			const double A0 = 1.0 + Alpha;
+			B0[Lane] = static_cast<float>(((1.0 - CosOmega) * 0.5) / A0);
+			B1[Lane] = static_cast<float>((1.0 - CosOmega) / A0);
+			B2[Lane] = B0[Lane];
+			A1[Lane] = static_cast<float>((-2.0 * CosOmega) / A0);
+			A2[Lane] = static_cast<float>((1.0 - Alpha) / A0);
+		}
+
+		void SetBandPass(std::size_t Lane, double Centre, std::uint32_t Rate, double Q)
+		{
+			const double Omega = 2.0 * std::numbers::pi * Centre / static_cast<double>(Rate);
+			const double Alpha = std::sin(Omega) / (2.0 * Q);
+			const double A0 = 1.0 + Alpha;
+			B0[Lane] = static_cast<float>(Alpha / A0);
+			B1[Lane] = 0.f;
+			B2[Lane] = static_cast<float>(-Alpha / A0);
+			A1[Lane] = static_cast<float>((-2.0 * std::cos(Omega)) / A0);
+			A2[Lane] = static_cast<float>((1.0 - Alpha) / A0);
+		}
+
+		void Reset()
+		{
+			for (std::size_t Lane = 0; Lane < 4; ++Lane)
+			{
+				Z1[Lane] = 0.f;
+				Z2[Lane] = 0.f;
+			}
+		}
+
+		/** Filters one sample per lane in place. */
+		void Process(float* Lanes)
+		{
+#if GAMEPAD_CORE_SIMD_SSE2
+			const __m128 Input = _mm_load_ps(Lanes);
+			const __m128 Output = _mm_add_ps(_mm_mul_ps(_mm_load_ps(B0), Input), _mm_load_ps(Z1));
+			_mm_store_ps(Z1, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_load_ps(B1), Input), _mm_mul_ps(_mm_load_ps(A1), Output)), _mm_load_ps(Z2)));
+			_mm_store_ps(Z2, _mm_sub_ps(_mm_mul_ps(_mm_load_ps(B2), Input), _mm_mul_ps(_mm_load_ps(A2), Output)));
+			_mm_store_ps(Lanes, Output);
+#elif GAMEPAD_CORE_SIMD_NEON
+			const float32x4_t Input = vld1q_f32(Lanes);
+			const float32x4_t Output = vmlaq_f32(vld1q_f32(Z1), vld1q_f32(B0), Input);
+			vst1q_f32(Z1, vaddq_f32(vmlsq_f32(vmulq_f32(vld1q_f32(B1), Input), vld1q_f32(A1), Output), vld1q_f32(Z2)));
+			vst1q_f32(Z2, vmlsq_f32(vmulq_f32(vld1q_f32(B2), Input), vld1q_f32(A2), Output));
+			vst1q_f32(Lanes, Output);
+#else
+			for (std::size_t Lane = 0; Lane < 4; ++Lane)
+			{
+				const float Output = (B0[Lane] * Lanes[Lane]) + Z1[Lane];
+				Z1[Lane] = (B1[Lane] * Lanes[Lane]) - (A1[Lane] * Output) + Z2[Lane];
+				Z2[Lane] = (B2[Lane] * Lanes[Lane]) - (A2[Lane] * Output);
+				Lanes[Lane] = Output;
+			}
+#endif
+		}
+	};
+
+	float SmoothingCoefficient(float Milliseconds) const
+	{
+		const float Samples = std::max(Milliseconds, 0.01f) * 0.001f * static_cast<float>(SampleRate);
+		return 1.f - std::exp(-1.f / Samples);
+	}
+
+	FHapticsDspConfig Config;
+	std::uint32_t SampleRate = 48000;
+	FBiquad4 Sections[2];
+	float Envelope[2] = {};
+	float SlowEnvelope[2] = {};
+	float AttackCoefficient = 1.f;
+	float ReleaseCoefficient = 1.f;
+	float SlowCoefficient = 1.f;
+};
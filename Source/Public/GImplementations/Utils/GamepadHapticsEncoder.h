@@ -0,0 +1,181 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GImplementations/Utils/GamepadAudio.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+
+/**
+ * @class FGamepadHapticsEncoder
+ * @brief Streaming encoder from PCM stereo audio to DualSense Bluetooth
+ * haptic packets.
+ *
+ * Over Bluetooth the controller plays 8-bit signed stereo haptics at 3 kHz,
+ * 32 frames (64 bytes) per audio report. The encoder accepts interleaved
+ * stereo PCM at any sample rate, band-limits it with a 4th-order Butterworth
+ * low-pass, resamples it with a fractional-phase interpolator and quantises
+ * the result. Every complete packet is handed to a callback. All state is
+ * held inline, so encoding never allocates.
+ */
+class FGamepadHapticsEncoder
+{
+public:
+	/** Sample rate of the Bluetooth haptic stream. */
+	static constexpr std::uint32_t OutputSampleRate = 3000;
+	/** Stereo frames carried by a single Bluetooth packet. */
+	static constexpr std::size_t FramesPerPacket = 32;
+	/** Size in bytes of the haptic payload of a Bluetooth packet. */
+	static constexpr std::size_t PacketSize = FramesPerPacket * 2;
+
+	FGamepadHapticsEncoder()
+	{
+		SetInputSampleRate(48000);
+	}
+
+	/**
+	 * Configures the rate of the PCM passed to Encode and resets the stream.
+	 *
+	 * @param InSampleRate The input sample rate in Hz.
+	 */
+	void SetInputSampleRate(std::uint32_t InSampleRate)
+	{
+		InputSampleRate = std::max<std::uint32_t>(InSampleRate, 1);
+		Step = static_cast<double>(InputSampleRate) / static_cast<double>(OutputSampleRate);
+
+		// Keep the pass band below the Nyquist frequency of the slower side.
+		const double Cutoff = 0.45 * static_cast<double>(std::min(InputSampleRate, OutputSampleRate));
+		Sections[0].SetLowPass(Cutoff, InputSampleRate, 0.54119610);
+		Sections[1].SetLowPass(Cutoff, InputSampleRate, 1.30656296);
+		Reset();
+	}
+
+	/**
+	 * @return The rate currently expected by Encode, in Hz.
+	 */
+	std::uint32_t GetInputSampleRate() const { return InputSampleRate; }
+
+	/**
+	 * Clears the filter history and drops any partially filled packet.
+	 */
+	void Reset()
+	{
+		for (FBiquad& Section : Sections)
+		{
+			Section.Reset();
+		}
+		Previous[0] = 0.f;
+		Previous[1] = 0.f;
+		Phase = 0.0;
+		PacketFrames = 0;
+	}
+
+	/**
+	 * Encodes interleaved stereo PCM (int16 or float) into Bluetooth packets.
+	 *
+	 * @param Samples Interleaved stereo samples (left, right).
+	 * @param OnPacket Called with a std::span<const std::uint8_t, 64> for every
+	 * packet completed by this call.
+	 */
+	template<typename TSample, typename TPacketCallback>
+	void Encode(std::span<const TSample> Samples, TPacketCallback&& OnPacket)
+	{
+		constexpr std::size_t ChunkFrames = 64;
+		float Chunk[ChunkFrames * 2];
+
+		const std::size_t Frames = Samples.size() / 2;
+		for (std::size_t Offset = 0; Offset < Frames; Offset += ChunkFrames)
+		{
+			const std::size_t Count = std::min(ChunkFrames, Frames - Offset);
+			FGamepadAudio::InterleaveHaptics(&Samples[Offset * 2], Chunk, Count, 2);
+			for (std::size_t Frame = 0; Frame < Count; ++Frame)
+			{
+				PushFrame(Chunk[Frame * 2], Chunk[(Frame * 2) + 1], OnPacket);
+			}
+		}
+	}
+
+private:
+	/**
+	 * Transposed direct form II biquad, one state pair per channel.
+	 */
+	struct FBiquad
+	{
+		float B0 = 1.f, B1 = 0.f, B2 = 0.f, A1 = 0.f, A2 = 0.f;
+		float Z1[2] = {};
+		float Z2[2] = {};
+
+		void SetLowPass(double Cutoff, std::uint32_t SampleRate, double Q)
+		{
+			const double Omega = 2.0 * std::numbers::pi * Cutoff / static_cast<double>(SampleRate);
+			const double Alpha = std::sin(Omega) / (2.0 * Q);
+			const double CosOmega = std::cos(Omega);
+			const double A0 = 1.0 + Alpha;
+			B0 = static_cast<float>(((1.0 - CosOmega) * 0.5) / A0);
+			B1 = static_cast<float>((1.0 - CosOmega) / A0);
+			B2 = B0;
+			A1 = static_cast<float>((-2.0 * CosOmega) / A0);
+			A2 = static_cast<float>((1.0 - Alpha) / A0);
+		}
+
+		void Reset()
+		{
+			Z1[0] = Z1[1] = 0.f;
+			Z2[0] = Z2[1] = 0.f;
+		}
+
+		float Process(float Input, int Channel)
+		{
+			const float Output = (B0 * Input) + Z1[Channel];
+			Z1[Channel] = (B1 * Input) - (A1 * Output) + Z2[Channel];
+			Z2[Channel] = (B2 * Input) - (A2 * Output);
+			return Output;
+		}
+	};
+
+	template<typename TPacketCallback>
+	void PushFrame(float Left, float Right, TPacketCallback& OnPacket)
+	{
+		const float Current[2] = {
+		    Sections[1].Process(Sections[0].Process(Left, 0), 0),
+		    Sections[1].Process(Sections[0].Process(Right, 1), 1)};
+
+		// Phase is the position of the next output sample, in input samples,
+		// measured from the previous filtered frame.
+		while (Phase <= 1.0)
+		{
+			const float Alpha = static_cast<float>(Phase);
+			Packet[PacketFrames * 2] = Quantize(Previous[0] + ((Current[0] - Previous[0]) * Alpha));
+			Packet[(PacketFrames * 2) + 1] = Quantize(Previous[1] + ((Current[1] - Previous[1]) * Alpha));
+			Phase += Step;
+
+			if (++PacketFrames == FramesPerPacket)
+			{
+				PacketFrames = 0;
+				OnPacket(std::span<const std::uint8_t, PacketSize>(Packet));
+			}
+		}
+		Phase -= 1.0;
+		Previous[0] = Current[0];
+		Previous[1] = Current[1];
+	}
+
+	static std::uint8_t Quantize(float Sample)
+	{
+		const float Scaled = std::clamp(Sample * 127.f, -127.f, 127.f);
+		return static_cast<std::uint8_t>(static_cast<std::int8_t>(std::lrint(Scaled)));
+	}
+
+	FBiquad Sections[2];
+	float Previous[2] = {};
+	double Phase = 0.0;
+	double Step = 16.0;
+	std::uint32_t InputSampleRate = 48000;
+	std::size_t PacketFrames = 0;
+	std::uint8_t Packet[PacketSize] = {};
+};
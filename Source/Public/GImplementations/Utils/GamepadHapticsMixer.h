@@ -0,0 +1,633 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Templates/TSpscBlockQueue.h"
+#include "GImplementations/Utils/GamepadAudio.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <utility>
+
+/**
+ * @class FGamepadHapticsMixer
+ * @brief Per-controller mixer of haptic voices.
+ *
+ * A fixed number of voices can be layered on a controller. A voice is either
+ * a stream, fed continuously by a producer thread, or a one-shot clip played
+ * from memory owned by the caller. Every voice has a gain and a priority:
+ * while a voice is audible, voices with a lower priority are ducked
+ * (sidechain). The mix goes through a peak limiter before it is handed to the
+ * haptics output.
+ *
+ * Voices are created and controlled from the game thread and rendered on the
+ * audio thread. A voice handle carries the generation of its slot, so a
+ * handle kept after its voice finished no longer matches the voice that
+ * reused the slot. The ducking and limiter settings are atomics and may
+ * change while rendering. All buffers are allocated by the constructor;
+ * rendering and pushing stream data never allocate nor lock.
+ */
+class FGamepadHapticsMixer
+{
+public:
+	/** Number of voices a controller can layer. */
+	static constexpr std::size_t MaxVoices = 8;
+	/** Frames mixed per internal step; gains and ducking update per step. */
+	static constexpr std::size_t RenderChunkFrames = 64;
+	/** Frames of a stream voice block, and blocks queued per stream voice. */
+	static constexpr std::size_t StreamBlockFrames = 128;
+	static constexpr std::size_t StreamBlockCount = 16;
+	/** Returned when no voice could be allocated. */
+	static constexpr std::int32_t InvalidVoice = -1;
+
+	FGamepadHapticsMixer()
+	{
+		for (FVoice& Voice : Voices)
+		{
+			Voice.Stream.Initialize(StreamBlockCount, StreamBlockFrames * 2);
+		}
+		SetSampleRate(48000);
+	}
+
+	FGamepadHapticsMixer(const FGamepadHapticsMixer&) = delete;
+	FGamepadHapticsMixer& operator=(const FGamepadHapticsMixer&) = delete;
+
+	/**
+	 * Sets the rate the mixer renders at, used to turn the ducking and limiter
+	 * times into per-step coefficients.
+	 */
+	void SetSampleRate(std::uint32_t InSampleRate)
+	{
+		SampleRate = std::max<std::uint32_t>(InSampleRate, 1);
+		SetDucking(DuckAmount.load(std::memory_order_relaxed), DuckThreshold.load(std::memory_order_relaxed), DuckAttackMs, DuckReleaseMs);
+		SetLimiter(LimiterThreshold.load(std::memory_order_relaxed), LimiterReleaseMs);
+	}
+
+	/**
+	 * Configures the sidechain ducking.
+	 *
+	 * @param Amount Attenuation applied to ducked voices, 0 (none) to 1 (mute).
+	 * @param Threshold Peak level above which a voice ducks lower priorities.
+	 * @param AttackMs Time to reach the ducked level.
+	 * @param ReleaseMs Time to recover once the higher priority voice is quiet.
+	 */
+	void SetDucking(float Amount, float Threshold, float AttackMs, float ReleaseMs)
+	{
+		DuckAmount.store(std::clamp(Amount, 0.f, 1.f), std::memory_order_relaxed);
+		DuckThreshold.store(std::max(Threshold, 0.f), std::memory_order_relaxed);
+		DuckAttackMs = AttackMs;
+		DuckReleaseMs = ReleaseMs;
+		DuckAttackCoefficient.store(StepCoefficient(AttackMs), std::memory_order_relaxed);
+		DuckReleaseCoefficient.store(StepCoefficient(ReleaseMs), std::memory_order_relaxed);
+	}
+
+	/**
+	 * Configures the output peak limiter.
+	 *
+	 * @param Threshold Maximum absolute output level.
+	 * @param ReleaseMs Time to recover the gain after a peak.
+	 */
+	void SetLimiter(float Threshold, float ReleaseMs)
+	{
+		LimiterThreshold.store(std::clamp(Threshold, 0.01f, 1.f), std::memory_order_relaxed);
+		LimiterReleaseMs = ReleaseMs;
+		LimiterReleaseCoefficient.store(StepCoefficient(ReleaseMs), std::memory_order_relaxed);
+	}
+
+	/**
+	 * Game thread: allocates a stream voice fed with PushStream.
+	 *
+	 * @param StartFrame Mixer frame (see GetRenderedFrames) the stream starts
+	 *                   on; samples pushed earlier wait for it. Past frames
+	 *                   start immediately.
+	 * @return The voice handle, or InvalidVoice if every voice is busy.
+	 */
+	std::int32_t CreateStream(std::uint8_t Priority, float Gain = 1.f, std::uint64_t StartFrame = 0)
+	{
+		const std::int32_t Index = FindFreeVoice();
+		if (Index == InvalidVoice)
+		{
+			return InvalidVoice;
+		}
+
+		StartVoice(Voices[Index], EVoiceState::Stream, Priority, Gain, StartFrame);
+		return MakeVoiceId(Index);
+	}
+
+	/**
+	 * Game thread: plays a clip once. The samples are read in place and must
+	 * stay valid until the voice finishes or is stopped.
+	 *
+	 * @param Interleaved Interleaved stereo float samples.
+	 * @param StartFrame Mixer frame (see GetRenderedFrames) the first sample
+	 *                   plays on. Past frames start immediately.
+	 * @return The voice handle, or InvalidVoice if every voice is busy.
+	 */
+	std::int32_t PlayClip(std::span<const float> Interleaved, std::uint8_t Priority, float Gain = 1.f, std::uint64_t StartFrame = 0)
+	{
+		if (Interleaved.size() < 2)
+		{
+			return InvalidVoice;
+		}
+
+		const std::int32_t Index = FindFreeVoice();
+		if (Index == InvalidVoice)
+		{
+			return InvalidVoice;
+		}
+
+		FVoice& Voice = Voices[Index];
+		Voice.ClipData = Interleaved.data();
+		Voice.ClipFrames = Interleaved.size() / 2;
+		Voice.ClipPosition = 0;
+		StartVoice(Voice, EVoiceState::Clip, Priority, Gain, StartFrame);
+		return MakeVoiceId(Index);
+	}
+
+	/**
+	 * Producer thread: queues samples on a stream voice. Samples that do not
+	 * fit are dropped.
+	 *
+	 * @return False if the voice is not a stream or the queue was full.
+	 */
+	template<typename TSample>
+	bool PushStream(std::int32_t VoiceId, std::span<const TSample> Interleaved)
+	{
+		FVoice* Found = FindVoice(VoiceId);
+		if (!Found || Found->StateWord.load(std::memory_order_acquire) != PackState(GetVoiceGeneration(VoiceId), EVoiceState::Stream))
+		{
+			return false;
+		}
+
+		FVoice& Voice = *Found;
+		std::size_t Frames = Interleaved.size() / 2;
+		const TSample* Samples = Interleaved.data();
+		while (Frames > 0)
+		{
+			float* Block = Voice.Stream.AcquireWrite();
+			if (!Block)
+			{
+				return false;
+			}
+
+			const std::size_t Count = std::min(Frames, StreamBlockFrames);
+			FGamepadAudio::InterleaveHaptics(Samples, Block, Count, 2);
+			Voice.Stream.CommitWrite(Count * 2);
+			Samples += Count * 2;
+			Frames -= Count;
+		}
+		return true;
+	}
+
+	/** Game thread: changes the gain of a voice; ramped on the next step. */
+	void SetVoiceGain(std::int32_t VoiceId, float Gain)
+	{
+		if (FVoice* Voice = FindVoice(VoiceId))
+		{
+			Voice->Gain.store(std::max(Gain, 0.f), std::memory_order_relaxed);
+		}
+	}
+
+	/** Game thread: changes the priority of a voice. */
+	void SetVoicePriority(std::int32_t VoiceId, std::uint8_t Priority)
+	{
+		if (FVoice* Voice = FindVoice(VoiceId))
+		{
+			Voice->Priority.store(Priority, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Game thread: stops a voice; it is released by the audio thread. For a
+	 * stream voice, the producer must have stopped pushing to it.
+	 */
+	void StopVoice(std::int32_t VoiceId)
+	{
+		FVoice* Voice = FindVoice(VoiceId);
+		if (!Voice)
+		{
+			return;
+		}
+
+		// The expected word carries the handle's generation, so the exchange
+		// fails if the slot was released and reused since FindVoice.
+		const std::uint32_t Generation = GetVoiceGeneration(VoiceId);
+		for (const EVoiceState Playing : {EVoiceState::Stream, EVoiceState::Clip})
+		{
+			std::uint32_t Expected = PackState(Generation, Playing);
+			if (Voice->StateWord.compare_exchange_strong(Expected, PackState(Generation, EVoiceState::Stopping), std::memory_order_acq_rel))
+			{
+				return;
+			}
+		}
+	}
+
+	/** @return True while the voice is playing. */
+	bool IsVoiceActive(std::int32_t VoiceId) const
+	{
+		const FVoice* Voice = FindVoice(VoiceId);
+		if (!Voice)
+		{
+			return false;
+		}
+
+		const std::uint32_t Word = Voice->StateWord.load(std::memory_order_acquire);
+		const EVoiceState State = GetState(Word);
+		return GetGeneration(Word) == GetVoiceGeneration(VoiceId) && (State == EVoiceState::Stream || State == EVoiceState::Clip);
+	}
+
+	/**
+	 * @return The frames rendered since construction: the mixer clock that
+	 * start frames refer to. The next Render call starts on this frame.
+	 */
+	std::uint64_t GetRenderedFrames() const { return RenderedFrames.load(std::memory_order_acquire); }
+
+	/**
+	 * Audio thread: renders the mix as interleaved stereo floats.
+	 *
+	 * @param OutInterleaved Destination, 2 * Frames floats.
+	 * @param Frames The number of frames to render.
+	 */
+	void Render(float* OutInterleaved, std::size_t Frames)
+	{
+		for (std::size_t Offset = 0; Offset < Frames; Offset += RenderChunkFrames)
+		{
+			RenderChunk(&OutInterleaved[Offset * 2], std::min(RenderChunkFrames, Frames - Offset));
+		}
+	}
+
+private:
+	enum class EVoiceState : std::uint8_t
+	{
+		Free,
+		Starting,
+		Stream,
+		Clip,
+		Stopping
+	};
+
+	struct FVoice
+	{
+		/**
+		 * EVoiceState in the low byte, the generation above it. The
+		 * generation is bumped each time the slot is allocated and is part of
+		 * the voice handle.
+		 */
+		std::atomic<std::uint32_t> StateWord = 0;
+		std::atomic<float> Gain = 1.f;
+		std::atomic<std::uint8_t> Priority = 0;
+		/** Mixer frame the voice starts on; set before the state is published. */
+		std::uint64_t StartFrame = 0;
+
+		// Clip voices: caller-owned samples, read position owned by the audio thread.
+		const float* ClipData = nullptr;
+		std::size_t ClipFrames = 0;
+		std::size_t ClipPosition = 0;
+
+		// Stream voices: producer blocks and the block being read.
+		GamepadCore::TSpscBlockQueue<float> Stream;
+		const float* ReadBlock = nullptr;
+		std::size_t ReadBlockElements = 0;
+		std::size_t ReadOffset = 0;
+
+		// Audio thread state.
+		bool bStarted = false;
+		float AppliedGain = 0.f;
+		float DuckGain = 1.f;
+		const float* Chunk = nullptr;
+		float Peak = 0.f;
+	};
+
+	/** Voice handles hold the slot index in the low bits, the generation above. */
+	static constexpr std::uint32_t VoiceIndexBits = 8;
+	static constexpr std::uint32_t VoiceGenerationMask = 0x7FFFFFu;
+	static_assert(MaxVoices <= (1u << VoiceIndexBits));
+	static constexpr std::uint32_t StateBits = 8;
+
+	static constexpr std::uint32_t PackState(std::uint32_t Generation, EVoiceState State)
+	{
+		return ((Generation & VoiceGenerationMask) << StateBits) | static_cast<std::uint32_t>(State);
+	}
+
+	static constexpr EVoiceState GetState(std::uint32_t Word)
+	{
+		return static_cast<EVoiceState>(Word & ((1u << StateBits) - 1));
+	}
+
+	static constexpr std::uint32_t GetGeneration(std::uint32_t Word)
+	{
+		return (Word >> StateBits) & VoiceGenerationMask;
+	}
+
+	static constexpr std::uint32_t GetVoiceGeneration(std::int32_t VoiceId)
+	{
+		return static_cast<std::uint32_t>(VoiceId) >> VoiceIndexBits;
+	}
+
+	static EVoiceState LoadState(const FVoice& Voice, std::memory_order Order)
+	{
+		return GetState(Voice.StateWord.load(Order));
+	}
+
+	std::int32_t MakeVoiceId(std::int32_t Index) const
+	{
+		const std::uint32_t Generation = GetGeneration(Voices[Index].StateWord.load(std::memory_order_relaxed));
+		return static_cast<std::int32_t>((Generation << VoiceIndexBits) | static_cast<std::uint32_t>(Index));
+	}
+
+	/**
+	 * @return The voice a handle refers to, or nullptr if the handle is
+	 * invalid or its slot was reused since.
+	 */
+	FVoice* FindVoice(std::int32_t VoiceId)
+	{
+		return const_cast<FVoice*>(std::as_const(*this).FindVoice(VoiceId));
+	}
+
+	const FVoice* FindVoice(std::int32_t VoiceId) const
+	{
+		if (VoiceId < 0)
+		{
+			return nullptr;
+		}
+
+		const std::uint32_t Id = static_cast<std::uint32_t>(VoiceId);
+		const std::size_t Index = Id & ((1u << VoiceIndexBits) - 1);
+		if (Index >= MaxVoices)
+		{
+			return nullptr;
+		}
+
+		const FVoice& Voice = Voices[Index];
+		return GetGeneration(Voice.StateWord.load(std::memory_order_acquire)) == GetVoiceGeneration(VoiceId) ? &Voice : nullptr;
+	}
+
+	std::int32_t FindFreeVoice()
+	{
+		for (std::size_t Index = 0; Index < MaxVoices; ++Index)
+		{
+			std::uint32_t Expected = Voices[Index].StateWord.load(std::memory_order_relaxed);
+			if (GetState(Expected) != EVoiceState::Free)
+			{
+				continue;
+			}
+
+			// Taking the slot bumps the generation, invalidating old handles.
+			const std::uint32_t Taken = PackState(GetGeneration(Expected) + 1, EVoiceState::Starting);
+			if (Voices[Index].StateWord.compare_exchange_strong(Expected, Taken, std::memory_order_acq_rel))
+			{
+				return static_cast<std::int32_t>(Index);
+			}
+		}
+		return InvalidVoice;
+	}
+
+	static void StartVoice(FVoice& Voice, EVoiceState State, std::uint8_t Priority, float Gain, std::uint64_t StartFrame)
+	{
+		Voice.StartFrame = StartFrame;
+		Voice.Gain.store(std::max(Gain, 0.f), std::memory_order_relaxed);
+		Voice.Priority.store(Priority, std::memory_order_relaxed);
+		const std::uint32_t Generation = GetGeneration(Voice.StateWord.load(std::memory_order_relaxed));
+		Voice.StateWord.store(PackState(Generation, State), std::memory_order_release);
+	}
+
+	/**
+	 * Audio thread: returns the voice to the free pool, discarding any stream
+	 * data still queued.
+	 */
+	static void ReleaseVoice(FVoice& Voice)
+	{
+		if (Voice.ReadBlock)
+		{
+			Voice.Stream.ConsumeElements(Voice.ReadBlockElements - Voice.ReadOffset);
+			Voice.Stream.CommitRead();
+			Voice.ReadBlock = nullptr;
+		}
+
+		std::size_t Elements = 0;
+		while (Voice.Stream.AcquireRead(Elements))
+		{
+			Voice.Stream.ConsumeElements(Elements);
+			Voice.Stream.CommitRead();
+		}
+
+		Voice.ClipData = nullptr;
+		Voice.bStarted = false;
+		Voice.AppliedGain = 0.f;
+		Voice.DuckGain = 1.f;
+		const std::uint32_t Generation = GetGeneration(Voice.StateWord.load(std::memory_order_relaxed));
+		Voice.StateWord.store(PackState(Generation, EVoiceState::Free), std::memory_order_release);
+	}
+
+	/**
+	 * Audio thread: points Voice.Chunk at the next Frames frames of the voice.
+	 * Clips are read in place; streams are gathered into the voice scratch.
+	 *
+	 * @return The frames available, possibly fewer than requested.
+	 */
+	std::size_t FetchChunk(FVoice& Voice, float* Scratch, std::size_t Frames)
+	{
+		if (LoadState(Voice, std::memory_order_relaxed) == EVoiceState::Clip)
+		{
+			const std::size_t Count = std::min(Frames, Voice.ClipFrames - Voice.ClipPosition);
+			Voice.Chunk = &Voice.ClipData[Voice.ClipPosition * 2];
+			Voice.ClipPosition += Count;
+			return Count;
+		}
+
+		const std::size_t ElementsWanted = Frames * 2;
+		std::size_t ElementsRead = 0;
+		while (ElementsRead < ElementsWanted)
+		{
+			if (!Voice.ReadBlock)
+			{
+				Voice.ReadBlock = Voice.Stream.AcquireRead(Voice.ReadBlockElements);
+				Voice.ReadOffset = 0;
+				if (!Voice.ReadBlock)
+				{
+					break;
+				}
+			}
+
+			const std::size_t Count = std::min(ElementsWanted - ElementsRead, Voice.ReadBlockElements - Voice.ReadOffset);
+			std::memcpy(&Scratch[ElementsRead], &Voice.ReadBlock[Voice.ReadOffset], Count * sizeof(float));
+			Voice.Stream.ConsumeElements(Count);
+			ElementsRead += Count;
+			Voice.ReadOffset += Count;
+			if (Voice.ReadOffset == Voice.ReadBlockElements)
+			{
+				Voice.Stream.CommitRead();
+				Voice.ReadBlock = nullptr;
+			}
+		}
+
+		// A starving stream keeps playing silence instead of ending.
+		std::memset(&Scratch[ElementsRead], 0, (ElementsWanted - ElementsRead) * sizeof(float));
+		Voice.Chunk = Scratch;
+		return Frames;
+	}
+
+	/**
+	 * Audio thread: like FetchChunk, but the voice only starts Offset frames
+	 * into the chunk; the frames before it are silent.
+	 */
+	std::size_t FetchChunkFrom(FVoice& Voice, float* Scratch, std::size_t Frames, std::size_t Offset)
+	{
+		if (Offset == 0)
+		{
+			return FetchChunk(Voice, Scratch, Frames);
+		}
+
+		float* Destination = &Scratch[Offset * 2];
+		const std::size_t Count = FetchChunk(Voice, Destination, Frames - Offset);
+		if (Voice.Chunk != Destination)
+		{
+			std::memcpy(Destination, Voice.Chunk, Count * 2 * sizeof(float));
+		}
+		std::memset(Scratch, 0, Offset * 2 * sizeof(float));
+		Voice.Chunk = Scratch;
+		return Offset + Count;
+	}
+
+	void RenderChunk(float* Out, std::size_t Frames)
+	{
+		const std::size_t Samples = Frames * 2;
+		std::memset(Out, 0, Samples * sizeof(float));
+		const std::uint64_t ChunkStart = ChunkClock;
+		ChunkClock += Frames;
+
+		// Settings may change between steps; each step uses one snapshot.
+		const float DuckThresholdNow = DuckThreshold.load(std::memory_order_relaxed);
+		const float DuckAmountNow = DuckAmount.load(std::memory_order_relaxed);
+		const float DuckAttackNow = DuckAttackCoefficient.load(std::memory_order_relaxed);
+		const float DuckReleaseNow = DuckReleaseCoefficient.load(std::memory_order_relaxed);
+		const float LimiterThresholdNow = LimiterThreshold.load(std::memory_order_relaxed);
+		const float LimiterReleaseNow = LimiterReleaseCoefficient.load(std::memory_order_relaxed);
+
+		// Pass 1: fetch every voice and find the highest audible priority.
+		std::size_t ChunkFrames[MaxVoices] = {};
+		int TopPriority = -1;
+		for (std::size_t Index = 0; Index < MaxVoices; ++Index)
+		{
+			FVoice& Voice = Voices[Index];
+			Voice.Chunk = nullptr;
+			const EVoiceState State = LoadState(Voice, std::memory_order_acquire);
+			if (State == EVoiceState::Stopping)
+			{
+				ReleaseVoice(Voice);
+				continue;
+			}
+
+			if (State != EVoiceState::Stream && State != EVoiceState::Clip)
+			{
+				continue;
+			}
+
+			// Voices scheduled past this chunk stay silent; one starting inside
+			// it starts on its exact frame.
+			if (Voice.StartFrame >= ChunkStart + Frames)
+			{
+				continue;
+			}
+
+			const std::size_t Offset = Voice.StartFrame > ChunkStart ? static_cast<std::size_t>(Voice.StartFrame - ChunkStart) : 0;
+			ChunkFrames[Index] = FetchChunkFrom(Voice, Scratch[Index].data(), Frames, Offset);
+			const float Gain = Voice.Gain.load(std::memory_order_relaxed);
+			Voice.Peak = FGamepadAudio::PeakAbs(Voice.Chunk, ChunkFrames[Index] * 2) * Gain;
+			if (Voice.Peak >= DuckThresholdNow && DuckThresholdNow > 0.f)
+			{
+				TopPriority = std::max<int>(TopPriority, Voice.Priority.load(std::memory_order_relaxed));
+			}
+		}
+
+		// Pass 2: duck the lower priorities and accumulate the voices fetched
+		// in pass 1.
+		for (std::size_t Index = 0; Index < MaxVoices; ++Index)
+		{
+			FVoice& Voice = Voices[Index];
+			const EVoiceState State = LoadState(Voice, std::memory_order_relaxed);
+			if ((State != EVoiceState::Stream && State != EVoiceState::Clip) || !Voice.Chunk)
+			{
+				continue;
+			}
+
+			const bool bDucked = static_cast<int>(Voice.Priority.load(std::memory_order_relaxed)) < TopPriority;
+			const float DuckTarget = bDucked ? 1.f - DuckAmountNow : 1.f;
+			const float Coefficient = DuckTarget < Voice.DuckGain ? DuckAttackNow : DuckReleaseNow;
+			Voice.DuckGain += (DuckTarget - Voice.DuckGain) * Coefficient;
+
+			const float TargetGain = Voice.Gain.load(std::memory_order_relaxed) * Voice.DuckGain;
+			if (!Voice.bStarted)
+			{
+				// Start on the full gain so a scheduled onset is not smeared
+				// by the gain ramp.
+				Voice.AppliedGain = TargetGain;
+				Voice.bStarted = true;
+			}
+			FGamepadAudio::MixAddRamp(Out, Voice.Chunk, ChunkFrames[Index] * 2, Voice.AppliedGain, TargetGain);
+			Voice.AppliedGain = TargetGain;
+
+			if (State == EVoiceState::Clip && Voice.ClipPosition >= Voice.ClipFrames)
+			{
+				ReleaseVoice(Voice);
+			}
+		}
+
+		// Limiter: instant attack, smoothed release. The ramp never exceeds the
+		// gain that keeps this chunk under the threshold.
+		const float Peak = FGamepadAudio::PeakAbs(Out, Samples);
+		const float SafeGain = Peak > LimiterThresholdNow ? LimiterThresholdNow / Peak : 1.f;
+		const float StartGain = std::min(LimiterGain, SafeGain);
+		const float EndGain = std::min(LimiterGain + ((1.f - LimiterGain) * LimiterReleaseNow), SafeGain);
+		if (StartGain < 1.f || EndGain < 1.f)
+		{
+			FGamepadAudio::ScaleRamp(Out, Samples, StartGain, EndGain);
+		}
+		LimiterGain = EndGain;
+		RenderedFrames.store(ChunkClock, std::memory_order_release);
+	}
+
+	/**
+	 * One-pole coefficient reaching ~63% of a change in TimeMs, applied once
+	 * per render step.
+	 */
+	float StepCoefficient(float TimeMs) const
+	{
+		if (TimeMs <= 0.f)
+		{
+			return 1.f;
+		}
+
+		const float StepsPerTime = (TimeMs * 0.001f * static_cast<float>(SampleRate)) / static_cast<float>(RenderChunkFrames);
+		return 1.f - std::exp(-1.f / std::max(StepsPerTime, 1e-3f));
+	}
+
+	std::array<FVoice, MaxVoices> Voices;
+	std::array<std::array<float, RenderChunkFrames * 2>, MaxVoices> Scratch = {};
+
+	/** Mixer clock: owned by the audio thread and published after each step. */
+	std::uint64_t ChunkClock = 0;
+	std::atomic<std::uint64_t> RenderedFrames = 0;
+
+	/** Settings as given, only used by the configuring thread. */
+	std::uint32_t SampleRate = 48000;
+	float DuckAttackMs = 5.f;
+	float DuckReleaseMs = 150.f;
+	float LimiterReleaseMs = 50.f;
+	/** Values read by the audio thread at each step. */
+	std::atomic<float> DuckAmount = 0.7f;
+	std::atomic<float> DuckThreshold = 0.05f;
+	std::atomic<float> DuckAttackCoefficient = 1.f;
+	std::atomic<float> DuckReleaseCoefficient = 1.f;
+	std::atomic<float> LimiterThreshold = 0.95f;
+	std::atomic<float> LimiterReleaseCoefficient = 1.f;
+	/** Audio thread state. */
+	float LimiterGain = 1.f;
+};
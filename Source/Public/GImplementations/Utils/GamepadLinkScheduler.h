@@ -0,0 +1,121 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Templates/TSpscBlockQueue.h"
+#include "GCore/Types/Structs/Config/BluetoothLink.h"
+#include "GCore/Utils/SoDefines.h"
+#include <atomic>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief Receives the traffic emitted by FGamepadLinkScheduler. Both calls
+ * run on the scheduler thread.
+ */
+class IGamepadLinkSink
+{
+public:
+	virtual ~IGamepadLinkSink() = default;
+	/** Sends one 64-byte haptic payload to the controller. */
+	virtual void SendHapticPacket(std::span<const std::uint8_t, 64> Packet) = 0;
+	/** Composes and sends the current output report. */
+	virtual void SendOutputReport() = 0;
+};
+
+/**
+ * @class FGamepadLinkScheduler
+ * @brief Per-device Bluetooth pacing of haptic packets and output reports.
+ *
+ * A dedicated thread emits queued haptic packets on the controller haptic
+ * cadence, waking with a coarse sleep and spinning for the last stretch so
+ * slots are hit with minimal jitter. Output report requests are coalesced
+ * and sent halfway between two slots, within a bandwidth budget, so they
+ * never collide with haptics nor get lost in a burst.
+ *
+ * Packets are queued by one producer (the haptics thread); output requests
+ * may come from any thread.
+ */
+class FGamepadLinkScheduler
+{
+public:
+	/** Haptic packet cadence: 32 frames at 3 kHz. */
+	static constexpr std::uint64_t SlotNumeratorUs = 32ull * 1000000ull;
+	static constexpr std::uint64_t SlotDenominator = 3000;
+	static constexpr std::size_t PacketSize = 64;
+
+	FGamepadLinkScheduler() = default;
+	FGamepadLinkScheduler(const FGamepadLinkScheduler&) = delete;
+	FGamepadLinkScheduler& operator=(const FGamepadLinkScheduler&) = delete;
+
+	~FGamepadLinkScheduler()
+	{
+		Stop();
+	}
+
+	/**
+	 * Starts the scheduler thread.
+	 *
+	 * @return False if already running, threads are unavailable or the queue
+	 * cannot be allocated.
+	 */
+	bool Start(IGamepadLinkSink* InSink, const FBluetoothLinkConfig& InConfig);
+
+	/**
+	 * Stops and joins the scheduler thread, then waits for a producer still
+	 * inside QueueHapticPacket; queued packets are discarded.
+	 */
+	void Stop();
+
+	bool IsRunning() const { return bRunning.load(std::memory_order_acquire); }
+
+	/**
+	 * Producer: queues a haptic packet for the next free slot.
+	 *
+	 * @return False if the queue was full and the packet was dropped.
+	 */
+	bool QueueHapticPacket(std::span<const std::uint8_t, 64> Packet);
+
+	/** Any thread: asks for the output report to be sent in the next gap. */
+	void RequestOutputReport()
+	{
+		bOutputPending.store(true, std::memory_order_release);
+	}
+
+	/** @return A snapshot of the counters. */
+	FBluetoothLinkStats GetStats() const;
+
+private:
+	void Run();
+	void WaitUntil(std::uint64_t DeadlineUs) const;
+	void SendPendingOutput(std::uint64_t NowUs);
+	void RaiseMax(std::uint64_t DelayUs);
+
+	std::uint64_t SlotTimeUs(std::uint64_t Slot) const
+	{
+		return StartUs + ((Slot * SlotNumeratorUs) / SlotDenominator);
+	}
+
+	IGamepadLinkSink* Sink = nullptr;
+	FBluetoothLinkConfig Config;
+	GamepadCore::TSpscBlockQueue<std::uint8_t> Packets;
+	std::atomic<bool> bRunning = false;
+	/** Producers inside QueueHapticPacket; Stop releases Packets once zero. */
+	std::atomic<std::uint32_t> ActiveProducers = 0;
+	std::atomic<bool> bOutputPending = false;
+	std::uint64_t StartUs = 0;
+	std::uint64_t LastOutputUs = 0;
+
+	std::atomic<std::uint64_t> SentPackets = 0;
+	std::atomic<std::uint64_t> DroppedPackets = 0;
+	std::atomic<std::uint64_t> LatePackets = 0;
+	std::atomic<std::uint64_t> EmptySlots = 0;
+	std::atomic<std::uint64_t> SentOutputReports = 0;
+	std::atomic<std::uint64_t> DeferredOutputReports = 0;
+	std::atomic<std::uint64_t> MaxSlotDelayUs = 0;
+
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	std::thread Thread;
+#endif
+};
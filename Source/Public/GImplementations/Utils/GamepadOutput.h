@@ -47,6 +47,49 @@ public:
 	 *                      for the controller's output functionalities.
 	 */
 	static void OutputDualShock(FDeviceContext* DeviceContext);
+	/**
+	 * OutputDualSense writing through a hardware policy bound at compile
+	 * time instead of the IPlatformHardwareInfo singleton.
+	 */
+	template<typename THardware>
+	static void OutputDualSense(FDeviceContext* DeviceContext, THardware& Hardware)
+	{
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(DeviceContext->OutputMutex);
+		ComposeDualSense(DeviceContext);
+		Hardware.Write(DeviceContext);
+	}
+	/**
+	 * OutputDualShock writing through a hardware policy bound at compile
+	 * time instead of the IPlatformHardwareInfo singleton.
+	 */
+	template<typename THardware>
+	static void OutputDualShock(FDeviceContext* DeviceContext, THardware& Hardware)
+	{
+		gc_lock::lock_guard<gc_lock::mutex> LockGuard(DeviceContext->OutputMutex);
+		ComposeDualShock(DeviceContext);
+		Hardware.Write(DeviceContext);
+	}
+	/**
+	 * Builds the DualSense output report into the device buffer without
+	 * submitting it. Bluetooth reports get their sequence toggle and CRC32
+	 * appended, so the buffer is ready to be written as is.
+	 *
+	 * @note The caller must hold DeviceContext->OutputMutex.
+	 *
+	 * @param DeviceContext The context whose output buffer is composed.
+	 * @return True if the report differs from the previously composed one.
+	 */
+	static bool ComposeDualSense(FDeviceContext* DeviceContext);
+	/**
+	 * Builds the DualShock output report into the device buffer without
+	 * submitting it.
+	 *
+	 * @note The caller must hold DeviceContext->OutputMutex.
+	 *
+	 * @param DeviceContext The context whose output buffer is composed.
+	 * @return True if the report differs from the previously composed one.
+	 */
+	static bool ComposeDualShock(FDeviceContext* DeviceContext);
 	/**
 	 * Configures the trigger effect settings on a PlayStation controller using
 	 * the provided haptic effect data.
@@ -71,4 +114,24 @@ public:
 	 * is processed and sent to the device.
 	 */
 	static void SendAudioHapticAdvanced(FDeviceContext* DeviceContext);
+	/**
+	 * SendAudioHapticAdvanced submitting through a hardware policy bound at
+	 * compile time instead of the IPlatformHardwareInfo singleton.
+	 */
+	template<typename THardware>
+	static void SendAudioHapticAdvanced(FDeviceContext* DeviceContext, THardware& Hardware)
+	{
+		if (ComposeAudioHaptic(DeviceContext))
+		{
+			Hardware.ProcessAudioHaptic(DeviceContext);
+		}
+	}
+	/**
+	 * Appends the CRC32 to the Bluetooth audio haptic report in the device
+	 * buffer.
+	 *
+	 * @return True if the report is ready to be submitted; only Bluetooth
+	 * devices take haptics through this report.
+	 */
+	static bool ComposeAudioHaptic(FDeviceContext* DeviceContext);
 };
@@ -0,0 +1,137 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Interfaces/ISonyGamepad.h"
+#include "GCore/Utils/SoDefines.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Waits for input readiness on many OS descriptors at once.
+ *
+ * Add and Remove may be called from any thread while Wait blocks on the
+ * reader thread. Readiness is level-triggered: a descriptor with unread
+ * reports is returned again by the next Wait.
+ */
+class IGamepadReadinessBackend
+{
+public:
+	virtual ~IGamepadReadinessBackend() = default;
+	/**
+	 * Starts watching a descriptor; Key is returned by Wait when it is
+	 * readable. A descriptor that hangs up or fails is returned once more
+	 * for a final read and may then stop being watched.
+	 */
+	virtual bool Add(std::intptr_t Descriptor, std::uint32_t Key) = 0;
+	/** Stops watching a descriptor. */
+	virtual void Remove(std::intptr_t Descriptor) = 0;
+	/**
+	 * Blocks until a descriptor is readable, Wake is called or the timeout
+	 * expires.
+	 *
+	 * @return The number of keys written to OutKeys.
+	 */
+	virtual std::size_t Wait(std::uint32_t TimeoutMs, std::uint32_t* OutKeys, std::size_t MaxKeys) = 0;
+	/** Makes a blocked Wait return early. Safe from any thread. */
+	virtual void Wake() = 0;
+
+	/**
+	 * Creates the backend of the platform: epoll on Linux, poll on other
+	 * POSIX systems.
+	 *
+	 * @return Nullptr where no backend is available.
+	 */
+	static std::unique_ptr<IGamepadReadinessBackend> CreateDefault();
+};
+
+/**
+ * @class FGamepadReaderEngine
+ * @brief Reads the input reports of every controller from a single thread.
+ *
+ * Instead of one thread per controller blocked in Read, the handles of all
+ * registered controllers are watched by one readiness backend. Whenever a
+ * handle becomes readable the engine calls UpdateInput on its controller,
+ * which reads, decodes and publishes the report; with level-triggered
+ * readiness every queued report is drained over consecutive waits.
+ *
+ * Controllers are registered through atomic slots like FGamepadAudioEngine;
+ * RemoveSource waits for the pass in flight, so a controller can be shut
+ * down right after. Handles without a poll descriptor are rejected and stay
+ * on their own update path.
+ */
+class FGamepadReaderEngine
+{
+public:
+	/** Maximum number of controllers read by the engine. */
+	static constexpr std::size_t MaxSources = 16;
+	/** Longest a wait blocks, so Stop is noticed even with idle handles. */
+	static constexpr std::uint32_t WaitTimeoutMs = 100;
+
+	/** @return The process-wide engine. */
+	static FGamepadReaderEngine& Get();
+
+	FGamepadReaderEngine(const FGamepadReaderEngine&) = delete;
+	FGamepadReaderEngine& operator=(const FGamepadReaderEngine&) = delete;
+	~FGamepadReaderEngine();
+
+	/**
+	 * Starts the reader thread.
+	 *
+	 * @param InBackend Backend to wait with, or nullptr for the platform
+	 *                  default.
+	 * @return False if already running, threads are unavailable or the
+	 * platform has no backend.
+	 */
+	bool Start(std::unique_ptr<IGamepadReadinessBackend> InBackend = nullptr);
+
+	/** Stops and joins the reader thread and unregisters every controller. */
+	void Stop();
+
+	/** @return True while the reader thread runs. */
+	bool IsRunning() const { return bRunning.load(std::memory_order_acquire); }
+
+	/**
+	 * Registers a controller whose input is read when its handle is ready.
+	 *
+	 * @param Source The controller to read.
+	 * @param Descriptor The poll descriptor of its handle, as returned by the
+	 * hardware policy that opened it.
+	 * @return False if the engine is not running, the descriptor is invalid,
+	 * the controller is already registered or every slot is taken.
+	 */
+	bool AddSource(ISonyGamepad* Source, std::intptr_t Descriptor);
+
+	/**
+	 * Unregisters a controller. On return the reader thread no longer uses
+	 * it, so its handle can be closed.
+	 */
+	void RemoveSource(ISonyGamepad* Source);
+
+	/**
+	 * Waits once and reads the controllers whose handle is ready. Called by
+	 * the reader thread.
+	 */
+	void Tick(std::uint32_t TimeoutMs);
+
+private:
+	FGamepadReaderEngine() = default;
+
+	void Run();
+	void WaitForPass();
+
+	std::array<std::atomic<ISonyGamepad*>, MaxSources> Sources = {};
+	std::array<std::intptr_t, MaxSources> Descriptors = {};
+	std::unique_ptr<IGamepadReadinessBackend> Backend;
+	/** Odd while a pass is reading; RemoveSource waits for it to move on. */
+	std::atomic<std::uint64_t> PassSequence = 0;
+	std::atomic<bool> bRunning = false;
+
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	std::thread Thread;
+#endif
+};
@@ -213,4 +213,40 @@ namespace FGamepadSensors
 		FinalAccel.Z = (fRawAccZ - Calibration.AccelBiasZ) * Calibration.AccelFactorZ;
 	}
 
+	/**
+	 * Averages the motion of several input reports, so a decode publishing
+	 * only the newest report still reflects the whole interval it covers.
+	 */
+	struct FMotionAccumulator
+	{
+		DSCoreTypes::DSVector3D GyroSum;
+		DSCoreTypes::DSVector3D AccelSum;
+		std::uint32_t Samples = 0;
+
+		void Add(const DSCoreTypes::DSVector3D& Gyro, const DSCoreTypes::DSVector3D& Accel)
+		{
+			GyroSum = {GyroSum.X + Gyro.X, GyroSum.Y + Gyro.Y, GyroSum.Z + Gyro.Z};
+			AccelSum = {AccelSum.X + Accel.X, AccelSum.Y + Accel.Y, AccelSum.Z + Accel.Z};
+			++Samples;
+		}
+
+		/**
+		 * Writes the averages of the samples added so far and starts over.
+		 *
+		 * @return False, leaving the outputs untouched, if none was added.
+		 */
+		bool Resolve(DSCoreTypes::DSVector3D& OutGyro, DSCoreTypes::DSVector3D& OutAccel)
+		{
+			if (Samples == 0)
+			{
+				return false;
+			}
+
+			const float Scale = 1.0f / static_cast<float>(Samples);
+			OutGyro = {GyroSum.X * Scale, GyroSum.Y * Scale, GyroSum.Z * Scale};
+			OutAccel = {AccelSum.X * Scale, AccelSum.Y * Scale, AccelSum.Z * Scale};
+			*this = FMotionAccumulator();
+			return true;
+		}
+	};
 } // namespace FGamepadSensors
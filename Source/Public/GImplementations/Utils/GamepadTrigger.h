@@ -8,6 +8,81 @@
 
 namespace FDualSenseTriggerComposer
 {
+	/**
+	 * Writes a continuous resistance effect (Mode 0x01) into a single trigger
+	 * effect, without touching the device context.
+	 *
+	 * @param Effect The trigger effect to be composed.
+	 * @param StartZones The starting position of the resistance zone.
+	 * @param Strength The level of resistance applied within the zone.
+	 */
+	inline void ComposeResistance(FGamepadTriggersHaptic& Effect, std::uint8_t StartZones, std::uint8_t Strength)
+	{
+		Effect.Mode = 0x01;
+		Effect.Strengths.Compose[0] = StartZones;
+		Effect.Strengths.Compose[1] = Strength;
+	}
+
+	/**
+	 * Writes a bow effect (Mode 0x22) into a single trigger effect.
+	 *
+	 * @param Effect The trigger effect to be composed.
+	 * @param StartZone The start position of the bow tension.
+	 * @param SnapBack The force applied when the trigger snaps back.
+	 */
+	inline void ComposeBow22(FGamepadTriggersHaptic& Effect, std::uint8_t StartZone, std::uint8_t SnapBack)
+	{
+		Effect.Mode = 0x22;
+		Effect.Strengths.Compose[0] = StartZone;
+		Effect.Strengths.Compose[1] = 0x01;
+		Effect.Strengths.Compose[2] = SnapBack;
+	}
+
+	/**
+	 * Writes a galloping effect (Mode 0x23) into a single trigger effect.
+	 *
+	 * @param Effect The trigger effect to be composed.
+	 * @param StartPosition The starting position of the galloping effect.
+	 * @param EndPosition The ending position of the galloping effect.
+	 * @param FirstFoot The strength of the first foot, ranging from 0-8.
+	 * @param SecondFoot The strength of the second foot, ranging from 0-8.
+	 * @param Frequency The frequency of the galloping effect.
+	 */
+	inline void ComposeGalloping23(FGamepadTriggersHaptic& Effect, std::uint8_t StartPosition,
+	                               std::uint8_t EndPosition, std::uint8_t FirstFoot,
+	                               std::uint8_t SecondFoot, std::uint8_t Frequency)
+	{
+		const std::uint8_t FirstFootNib = static_cast<std::uint8_t>(std::clamp(
+		    static_cast<int>(std::lround((FirstFoot / 8) * 15)), 1, 15));
+		const std::uint8_t SecondFootNib = static_cast<std::uint8_t>(std::clamp(
+		    static_cast<int>(std::lround((SecondFoot / 8) * 15)), 1, 15));
+		const std::uint16_t PositionMask = (1 << StartPosition) | (1 << EndPosition);
+
+		Effect.Mode = 0x23;
+		Effect.Strengths.Compose[0] = PositionMask & 0xFF;
+		Effect.Strengths.Compose[1] = (PositionMask >> 8) & 0xFF;
+		Effect.Strengths.Compose[2] = ((FirstFootNib & 0x0F) << 4) | (SecondFootNib & 0x0F);
+		Effect.Strengths.Compose[3] = Frequency;
+	}
+
+	/**
+	 * Writes a weapon effect (Mode 0x25) into a single trigger effect.
+	 *
+	 * @param Effect The trigger effect to be composed.
+	 * @param StartZone The starting position of the trigger's actuation zone.
+	 * @param Amplitude The intensity of the trigger's feedback effect.
+	 * @param Behavior The type of feedback behavior applied to the trigger.
+	 * @param Trigger The trigger specific parameter of the effect.
+	 */
+	inline void ComposeWeapon25(FGamepadTriggersHaptic& Effect, std::uint8_t StartZone,
+	                            std::uint8_t Amplitude, std::uint8_t Behavior, std::uint8_t Trigger)
+	{
+		Effect.Mode = 0x25;
+		Effect.Strengths.Compose[0] = StartZone << 4 | (Amplitude & 0x0F);
+		Effect.Strengths.Compose[1] = Behavior;
+		Effect.Strengths.Compose[2] = Trigger & 0x0F;
+	}
+
 	/**
 	 * Disables the trigger functionality for the specified hand or hands on the
 	 * provided device context.
@@ -48,15 +123,11 @@ namespace FDualSenseTriggerComposer
 	{
 		if (Hand == EDSGamepadHand::Left || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.LeftTrigger.Mode = 0x01;
-			Context->Output.LeftTrigger.Strengths.Compose[0] = StartZones;
-			Context->Output.LeftTrigger.Strengths.Compose[1] = Strength;
+			ComposeResistance(Context->Output.LeftTrigger, StartZones, Strength);
 		}
 		if (Hand == EDSGamepadHand::Right || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.RightTrigger.Mode = 0x01;
-			Context->Output.RightTrigger.Strengths.Compose[0] = StartZones;
-			Context->Output.RightTrigger.Strengths.Compose[1] = Strength;
+			ComposeResistance(Context->Output.RightTrigger, StartZones, Strength);
 		}
 	}
 
@@ -93,18 +164,12 @@ namespace FDualSenseTriggerComposer
 	{
 		if (Hand == EDSGamepadHand::Left || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.LeftTrigger.Mode = 0x22;
-			Context->Output.LeftTrigger.Strengths.Compose[0] = StartZone;
-			Context->Output.LeftTrigger.Strengths.Compose[1] = 0x01;
-			Context->Output.LeftTrigger.Strengths.Compose[2] = SnapBack;
+			ComposeBow22(Context->Output.LeftTrigger, StartZone, SnapBack);
 		}
 
 		if (Hand == EDSGamepadHand::Right || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.RightTrigger.Mode = 0x22;
-			Context->Output.RightTrigger.Strengths.Compose[0] = StartZone;
-			Context->Output.RightTrigger.Strengths.Compose[1] = 0x01;
-			Context->Output.RightTrigger.Strengths.Compose[2] = SnapBack;
+			ComposeBow22(Context->Output.RightTrigger, StartZone, SnapBack);
 		}
 	}
 
@@ -113,31 +178,14 @@ namespace FDualSenseTriggerComposer
 	                        std::uint8_t SecondFoot, std::uint8_t Frequency,
 	                        const EDSGamepadHand& Hand)
 	{
-		const std::uint8_t FirstFootNib = static_cast<std::uint8_t>(std::clamp(
-		    static_cast<int>(std::lround((FirstFoot / 8) * 15)), 1, 15));
-		const std::uint8_t SecondFootNib = static_cast<std::uint8_t>(std::clamp(
-		    static_cast<int>(std::lround((SecondFoot / 8) * 15)), 1, 15));
-		const std::uint16_t PositionMask = (1 << StartPosition) | (1 << EndPosition);
 		if (Hand == EDSGamepadHand::Left || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.LeftTrigger.Mode = 0x23;
-			Context->Output.LeftTrigger.Strengths.Compose[0] = PositionMask & 0xFF;
-			Context->Output.LeftTrigger.Strengths.Compose[1] =
-			    (PositionMask >> 8) & 0xFF;
-			Context->Output.LeftTrigger.Strengths.Compose[2] =
-			    ((FirstFootNib & 0x0F) << 4) | (SecondFootNib & 0x0F);
-			Context->Output.LeftTrigger.Strengths.Compose[3] = Frequency;
+			ComposeGalloping23(Context->Output.LeftTrigger, StartPosition, EndPosition, FirstFoot, SecondFoot, Frequency);
 		}
 
 		if (Hand == EDSGamepadHand::Right || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.RightTrigger.Mode = 0x23;
-			Context->Output.RightTrigger.Strengths.Compose[0] = PositionMask & 0xFF;
-			Context->Output.RightTrigger.Strengths.Compose[1] =
-			    (PositionMask >> 8) & 0xFF;
-			Context->Output.RightTrigger.Strengths.Compose[2] =
-			    ((FirstFootNib & 0x0F) << 4) | (SecondFootNib & 0x0F);
-			Context->Output.RightTrigger.Strengths.Compose[3] = Frequency;
+			ComposeGalloping23(Context->Output.RightTrigger, StartPosition, EndPosition, FirstFoot, SecondFoot, Frequency);
 		}
 	}
 
@@ -147,20 +195,12 @@ namespace FDualSenseTriggerComposer
 	{
 		if (Hand == EDSGamepadHand::Left || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.LeftTrigger.Mode = 0x25;
-			Context->Output.LeftTrigger.Strengths.Compose[0] =
-			    StartZone << 4 | (Amplitude & 0x0F);
-			Context->Output.LeftTrigger.Strengths.Compose[1] = Behavior;
-			Context->Output.LeftTrigger.Strengths.Compose[2] = Trigger & 0x0F;
+			ComposeWeapon25(Context->Output.LeftTrigger, StartZone, Amplitude, Behavior, Trigger);
 		}
 
 		if (Hand == EDSGamepadHand::Right || Hand == EDSGamepadHand::AnyHand)
 		{
-			Context->Output.RightTrigger.Mode = 0x25;
-			Context->Output.RightTrigger.Strengths.Compose[0] =
-			    StartZone << 4 | (Amplitude & 0x0F);
-			Context->Output.RightTrigger.Strengths.Compose[1] = Behavior;
-			Context->Output.RightTrigger.Strengths.Compose[2] = Trigger & 0x0F;
+			ComposeWeapon25(Context->Output.RightTrigger, StartZone, Amplitude, Behavior, Trigger);
 		}
 	}
 
@@ -231,7 +271,7 @@ namespace FDualSenseTriggerComposer
 	}
 
 	inline void CustomTrigger(FDeviceContext* Context, const EDSGamepadHand& Hand,
-	                          const std::vector<std::uint8_t>& HexBytes)
+	                          std::span<const std::uint8_t, 10> HexBytes)
 	{
 		switch (HexBytes[0])
 		{
@@ -0,0 +1,192 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Types/DSCoreTypes.h"
+#include "GCore/Types/ECoreGamepad.h"
+#include "GCore/Types/Structs/Config/GamepadTriggerKeyframe.h"
+#include "GCore/Types/Structs/Context/OutputContext.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * @class FGamepadTriggerSequence
+ * @brief Timeline of adaptive trigger keyframes for a single hand.
+ *
+ * The sequence is evaluated against a monotonic clock in microseconds, so the
+ * resulting effect only depends on the time at which the output report is
+ * built and not on how often the game updates the controller.
+ */
+class FGamepadTriggerSequence
+{
+public:
+	/**
+	 * Starts playing the given keyframes from the beginning.
+	 *
+	 * @param InKeyframes The keyframes to be played. They are sorted by TimeMs.
+	 * @param bInLoop Whether the sequence restarts after its last keyframe.
+	 * @param NowUs The current monotonic time in microseconds.
+	 */
+	void Play(const std::vector<FGamepadTriggerKeyframe>& InKeyframes, bool bInLoop, std::uint64_t NowUs)
+	{
+		Keyframes = InKeyframes;
+		std::stable_sort(Keyframes.begin(), Keyframes.end(), [](const FGamepadTriggerKeyframe& A, const FGamepadTriggerKeyframe& B) {
+			return A.TimeMs < B.TimeMs;
+		});
+
+		bLoop = bInLoop;
+		StartUs = NowUs;
+		bPlaying = !Keyframes.empty();
+	}
+
+	/**
+	 * Stops the sequence. The last evaluated effect stays on the trigger.
+	 */
+	void Stop() { bPlaying = false; }
+
+	/**
+	 * @return True while the sequence still drives the trigger.
+	 */
+	bool IsPlaying() const { return bPlaying; }
+
+	/**
+	 * Evaluates the sequence at the given time.
+	 *
+	 * @param NowUs The current monotonic time in microseconds.
+	 * @param OutEffect The trigger effect to be written. Left untouched when the
+	 * sequence is not playing.
+	 * @return True if OutEffect was written.
+	 */
+	bool Evaluate(std::uint64_t NowUs, FGamepadTriggersHaptic& OutEffect)
+	{
+		if (!bPlaying)
+		{
+			return false;
+		}
+
+		const double DurationMs = static_cast<double>(Keyframes.back().TimeMs);
+		double ElapsedMs = static_cast<double>(NowUs - StartUs) / 1000.0;
+		if (ElapsedMs >= DurationMs)
+		{
+			if (!bLoop || DurationMs <= 0.0)
+			{
+				OutEffect = Keyframes.back().Effect;
+				bPlaying = false;
+				return true;
+			}
+			ElapsedMs = std::fmod(ElapsedMs, DurationMs);
+		}
+
+		const auto Next = std::upper_bound(Keyframes.begin(), Keyframes.end(), ElapsedMs, [](double Time, const FGamepadTriggerKeyframe& Key) {
+			return Time < static_cast<double>(Key.TimeMs);
+		});
+
+		if (Next == Keyframes.begin())
+		{
+			OutEffect = Next->Effect;
+			return true;
+		}
+
+		const auto Prev = Next - 1;
+		if (Next == Keyframes.end() || Next->Blend != EDSTriggerBlend::Linear || !CanInterpolate(Prev->Effect, Next->Effect))
+		{
+			OutEffect = Prev->Effect;
+			return true;
+		}
+
+		const double Span = static_cast<double>(Next->TimeMs - Prev->TimeMs);
+		const float Alpha = Span > 0.0 ? static_cast<float>((ElapsedMs - Prev->TimeMs) / Span) : 1.0f;
+		OutEffect = Prev->Effect;
+		for (const int Index : {0, 1, 2})
+		{
+			const float From = Prev->Effect.Strengths.Compose[Index];
+			const float To = Next->Effect.Strengths.Compose[Index];
+			OutEffect.Strengths.Compose[Index] = static_cast<std::uint8_t>(std::lround(From + ((To - From) * Alpha)));
+		}
+		return true;
+	}
+
+private:
+	/**
+	 * Only plain byte parameters can be interpolated: the start zone and
+	 * strength of the continuous resistance (0x01) and the start zone and
+	 * snap back of the bow (0x22). The other modes pack nibbles or bit masks.
+	 */
+	static bool CanInterpolate(const FGamepadTriggersHaptic& From, const FGamepadTriggersHaptic& To)
+	{
+		return From.Mode == To.Mode && (From.Mode == 0x01 || From.Mode == 0x22);
+	}
+
+	std::vector<FGamepadTriggerKeyframe> Keyframes;
+	std::uint64_t StartUs = 0;
+	bool bLoop = false;
+	bool bPlaying = false;
+};
+
+/**
+ * @class FGamepadTriggerSequencer
+ * @brief Runs one FGamepadTriggerSequence per trigger and writes the result
+ * into the output context right before the report is built.
+ */
+class FGamepadTriggerSequencer
+{
+public:
+	void Play(const EDSGamepadHand& Hand, const std::vector<FGamepadTriggerKeyframe>& Keyframes, bool bLoop, std::uint64_t NowUs)
+	{
+		if (Hand == EDSGamepadHand::Left || Hand == EDSGamepadHand::AnyHand)
+		{
+			Left.Play(Keyframes, bLoop, NowUs);
+		}
+
+		if (Hand == EDSGamepadHand::Right || Hand == EDSGamepadHand::AnyHand)
+		{
+			Right.Play(Keyframes, bLoop, NowUs);
+		}
+	}
+
+	void Stop(const EDSGamepadHand& Hand)
+	{
+		if (Hand == EDSGamepadHand::Left || Hand == EDSGamepadHand::AnyHand)
+		{
+			Left.Stop();
+		}
+
+		if (Hand == EDSGamepadHand::Right || Hand == EDSGamepadHand::AnyHand)
+		{
+			Right.Stop();
+		}
+	}
+
+	bool IsPlaying(const EDSGamepadHand& Hand) const
+	{
+		if (Hand == EDSGamepadHand::Left)
+		{
+			return Left.IsPlaying();
+		}
+
+		if (Hand == EDSGamepadHand::Right)
+		{
+			return Right.IsPlaying();
+		}
+		return Left.IsPlaying() || Right.IsPlaying();
+	}
+
+	/**
+	 * Advances both sequences to the given time and writes the evaluated
+	 * effects into the output context.
+	 *
+	 * @param Output The output context the next report is built from.
+	 * @param NowUs The current monotonic time in microseconds.
+	 */
+	void Tick(FOutputContext& Output, std::uint64_t NowUs)
+	{
+		Left.Evaluate(NowUs, Output.LeftTrigger);
+		Right.Evaluate(NowUs, Output.RightTrigger);
+	}
+
+private:
+	FGamepadTriggerSequence Left;
+	FGamepadTriggerSequence Right;
+};
@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+#pragma once
+#include "GCore/Templates/TSpscBlockQueue.h"
+#include "GCore/Utils/SoDefines.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class FGamepadWorkerPool
+ * @brief Small fixed pool that runs the iterations of a loop in parallel.
+ *
+ * ParallelFor splits the index range into one contiguous share per thread
+ * (the caller included). Each thread claims indices from the front of its
+ * own share and, once it is empty, steals from the shares of the others, so
+ * a slow device does not hold back the rest. Claims are single atomic
+ * increments and the job is passed by pointer, so a call never allocates.
+ *
+ * Only one ParallelFor may run at a time. On embedded targets, or when no
+ * worker is started, the loop runs on the caller.
+ */
+class FGamepadWorkerPool
+{
+public:
+	/** Maximum number of worker threads, not counting the caller. */
+	static constexpr std::size_t MaxWorkers = 15;
+
+	FGamepadWorkerPool() = default;
+	FGamepadWorkerPool(const FGamepadWorkerPool&) = delete;
+	FGamepadWorkerPool& operator=(const FGamepadWorkerPool&) = delete;
+
+	~FGamepadWorkerPool()
+	{
+		Stop();
+	}
+
+	/**
+	 * Starts the worker threads.
+	 *
+	 * @param InWorkers Threads to start besides the caller; zero picks one
+	 *                  less than the hardware concurrency.
+	 * @return False if already running or threads are unavailable.
+	 */
+	bool Start(std::size_t InWorkers = 0);
+
+	/** Stops and joins the worker threads. */
+	void Stop();
+
+	/** @return The number of threads taking part in a ParallelFor. */
+	std::size_t GetConcurrency() const { return WorkerCount + 1; }
+
+	/**
+	 * Calls Func(Index) for every index in [0, Count) across the pool and
+	 * returns once all calls have completed.
+	 */
+	template<typename TFunc>
+	void ParallelFor(std::size_t Count, TFunc& Func)
+	{
+		Run(Count, &Func, [](void* Context, std::size_t Index) {
+			(*static_cast<TFunc*>(Context))(Index);
+		});
+	}
+
+private:
+	using FJobFunction = void (*)(void* Context, std::size_t Index);
+
+	/**
+	 * Range of indices still to claim by the thread owning it, or by
+	 * thieves. Kept on its own cache line.
+	 */
+	struct alignas(GamepadCore::CacheLineSize) FShare
+	{
+		std::atomic<std::size_t> Next = 0;
+		std::size_t End = 0;
+	};
+
+	void Run(std::size_t Count, void* Context, FJobFunction Function);
+	void Work(std::size_t Participant);
+	void WorkerLoop(std::size_t Participant, std::uint64_t Seen);
+
+	std::array<FShare, MaxWorkers + 1> Shares;
+	void* JobContext = nullptr;
+	FJobFunction JobFunction = nullptr;
+	/** Bumped to release the workers on a new job. */
+	std::atomic<std::uint64_t> Generation = 0;
+	/** Workers still running the current job. */
+	std::atomic<std::size_t> Busy = 0;
+	std::atomic<bool> bRunning = false;
+	std::size_t WorkerCount = 0;
+
+#if !defined(GAMEPAD_CORE_EMBEDDED)
+	std::array<std::thread, MaxWorkers> Workers;
+#endif
+};
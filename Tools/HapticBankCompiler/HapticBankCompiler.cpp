@@ -0,0 +1,296 @@
+// Copyright (c) 2025 Rafael Valoto. All Rights Reserved.
+// Project: GamepadCore
+// Description: Cross-platform library for DualSense and generic gamepad input support.
+// Targets: Windows, Linux, macOS.
+
+// Compiles WAV clips into a haptic bank read by FGamepadHapticBank.
+//
+// Usage: HapticBankCompiler [--rate <Hz>] <output.ghb> <id>=<clip.wav> [<id>=<clip.wav> ...]
+//
+// Clips are converted to stereo float at the bank rate (48 kHz by default)
+// and pre-encoded into Bluetooth haptic packets. Over USB, clips only play on
+// controllers whose haptics sample rate matches the bank rate.
+
+#include "GImplementations/Utils/GamepadHapticBank.h"
+#include "GImplementations/Utils/GamepadHapticsEncoder.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace FHapticBankFormat;
+
+namespace
+{
+	struct FClip
+	{
+		std::uint32_t Id = 0;
+		std::string Path;
+		std::vector<float> Pcm;
+		std::vector<std::uint8_t> Packets;
+	};
+
+	std::uint32_t ReadU32(const std::uint8_t* Bytes)
+	{
+		return static_cast<std::uint32_t>(Bytes[0]) | (static_cast<std::uint32_t>(Bytes[1]) << 8) | (static_cast<std::uint32_t>(Bytes[2]) << 16) | (static_cast<std::uint32_t>(Bytes[3]) << 24);
+	}
+
+	std::uint16_t ReadU16(const std::uint8_t* Bytes)
+	{
+		return static_cast<std::uint16_t>(Bytes[0] | (Bytes[1] << 8));
+	}
+
+	/**
+	 * Decodes a PCM16, PCM24 or float32 WAV file into interleaved stereo
+	 * floats. Mono files are duplicated on both channels; channels beyond
+	 * the second are ignored.
+	 */
+	bool LoadWav(const std::string& Path, std::vector<float>& OutStereo, std::uint32_t& OutSampleRate)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		const std::vector<std::uint8_t> Bytes((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+		if (Bytes.size() < 12 || std::memcmp(Bytes.data(), "RIFF", 4) != 0 || std::memcmp(&Bytes[8], "WAVE", 4) != 0)
+		{
+			return false;
+		}
+
+		std::uint16_t Format = 0;
+		std::uint16_t Channels = 0;
+		std::uint16_t Bits = 0;
+		const std::uint8_t* Samples = nullptr;
+		std::size_t SampleBytes = 0;
+		for (std::size_t Offset = 12; Offset + 8 <= Bytes.size();)
+		{
+			const std::uint32_t ChunkSize = ReadU32(&Bytes[Offset + 4]);
+			const std::uint8_t* Chunk = &Bytes[Offset + 8];
+			const std::size_t Available = std::min<std::size_t>(ChunkSize, Bytes.size() - Offset - 8);
+			if (std::memcmp(&Bytes[Offset], "fmt ", 4) == 0 && Available >= 16)
+			{
+				Format = ReadU16(Chunk);
+				Channels = ReadU16(&Chunk[2]);
+				OutSampleRate = ReadU32(&Chunk[4]);
+				Bits = ReadU16(&Chunk[14]);
+				// WAVE_FORMAT_EXTENSIBLE: the real format leads the sub-format GUID.
+				if (Format == 0xFFFE && Available >= 26)
+				{
+					Format = ReadU16(&Chunk[24]);
+				}
+			}
+			else if (std::memcmp(&Bytes[Offset], "data", 4) == 0)
+			{
+				Samples = Chunk;
+				SampleBytes = Available;
+			}
+			Offset += 8 + ChunkSize + (ChunkSize & 1);
+		}
+
+		const bool bPcm = Format == 1 && (Bits == 16 || Bits == 24);
+		const bool bFloat = Format == 3 && Bits == 32;
+		if (!Samples || Channels == 0 || OutSampleRate == 0 || (!bPcm && !bFloat))
+		{
+			return false;
+		}
+
+		const std::size_t BytesPerSample = Bits / 8;
+		const std::size_t Frames = SampleBytes / (BytesPerSample * Channels);
+		OutStereo.resize(Frames * 2);
+		for (std::size_t Frame = 0; Frame < Frames; ++Frame)
+		{
+			for (std::size_t Channel = 0; Channel < 2; ++Channel)
+			{
+				const std::size_t Source = std::min<std::size_t>(Channel, Channels - 1);
+				const std::uint8_t* Sample = &Samples[((Frame * Channels) + Source) * BytesPerSample];
+				float Value = 0.f;
+				if (bFloat)
+				{
+					std::memcpy(&Value, Sample, sizeof(float));
+				}
+				else if (Bits == 16)
+				{
+					Value = static_cast<float>(static_cast<std::int16_t>(ReadU16(Sample))) / 32768.f;
+				}
+				else
+				{
+					const std::int32_t Packed = static_cast<std::int32_t>((static_cast<std::uint32_t>(Sample[0]) << 8) | (static_cast<std::uint32_t>(Sample[1]) << 16) | (static_cast<std::uint32_t>(Sample[2]) << 24));
+					Value = static_cast<float>(Packed >> 8) / 8388608.f;
+				}
+				OutStereo[(Frame * 2) + Channel] = std::clamp(Value, -1.f, 1.f);
+			}
+		}
+		return true;
+	}
+
+	/** Linear-interpolation resampler; clips are short and band-limited by the encoder. */
+	std::vector<float> Resample(const std::vector<float>& Stereo, std::uint32_t InRate, std::uint32_t OutRate)
+	{
+		const std::size_t InFrames = Stereo.size() / 2;
+		if (InRate == OutRate || InFrames < 2)
+		{
+			return Stereo;
+		}
+
+		const double Step = static_cast<double>(InRate) / static_cast<double>(OutRate);
+		const std::size_t OutFrames = static_cast<std::size_t>(static_cast<double>(InFrames - 1) / Step) + 1;
+		std::vector<float> Out(OutFrames * 2);
+		for (std::size_t Frame = 0; Frame < OutFrames; ++Frame)
+		{
+			const double Position = static_cast<double>(Frame) * Step;
+			const std::size_t Index = std::min(static_cast<std::size_t>(Position), InFrames - 2);
+			const float Alpha = static_cast<float>(Position - static_cast<double>(Index));
+			for (std::size_t Channel = 0; Channel < 2; ++Channel)
+			{
+				const float A = Stereo[(Index * 2) + Channel];
+				const float B = Stereo[((Index + 1) * 2) + Channel];
+				Out[(Frame * 2) + Channel] = A + ((B - A) * Alpha);
+			}
+		}
+		return Out;
+	}
+
+	std::vector<std::uint8_t> EncodeBluetooth(const std::vector<float>& Pcm, std::uint32_t SampleRate)
+	{
+		std::vector<std::uint8_t> Packets;
+		FGamepadHapticsEncoder Encoder;
+		Encoder.SetInputSampleRate(SampleRate);
+		const auto OnPacket = [&Packets](std::span<const std::uint8_t, 64> Packet) {
+			Packets.insert(Packets.end(), Packet.begin(), Packet.end());
+		};
+		Encoder.Encode(std::span<const float>(Pcm), OnPacket);
+
+		// Flush the last partial packet with silence.
+		const std::vector<float> Silence(static_cast<std::size_t>(FGamepadHapticsEncoder::FramesPerPacket) * 2 * ((SampleRate / FGamepadHapticsEncoder::OutputSampleRate) + 1), 0.f);
+		const std::size_t Before = Packets.size();
+		if (!Pcm.empty())
+		{
+			Encoder.Encode(std::span<const float>(Silence), [&](std::span<const std::uint8_t, 64> Packet) {
+				if (Packets.size() == Before)
+				{
+					OnPacket(Packet);
+				}
+			});
+		}
+		return Packets;
+	}
+
+	std::uint64_t AlignUp(std::uint64_t Value)
+	{
+		return (Value + PayloadAlignment - 1) & ~(PayloadAlignment - 1);
+	}
+
+	void WriteAt(std::vector<std::uint8_t>& Bank, std::uint64_t Offset, const void* Data, std::size_t Size)
+	{
+		if (Size == 0)
+		{
+			return;
+		}
+		if (Bank.size() < Offset + Size)
+		{
+			Bank.resize(Offset + Size);
+		}
+		std::memcpy(&Bank[Offset], Data, Size);
+	}
+
+	int Usage()
+	{
+		std::fprintf(stderr, "Usage: HapticBankCompiler [--rate <Hz>] <output.ghb> <id>=<clip.wav> [<id>=<clip.wav> ...]\n");
+		return 1;
+	}
+} // namespace
+
+int main(int Argc, char** Argv)
+{
+	std::uint32_t SampleRate = 48000;
+	int Arg = 1;
+	if (Arg + 1 < Argc && std::strcmp(Argv[Arg], "--rate") == 0)
+	{
+		SampleRate = static_cast<std::uint32_t>(std::strtoul(Argv[Arg + 1], nullptr, 10));
+		Arg += 2;
+	}
+	if (SampleRate == 0 || Arg + 1 >= Argc)
+	{
+		return Usage();
+	}
+
+	const char* OutputPath = Argv[Arg++];
+	std::vector<FClip> Clips;
+	for (; Arg < Argc; ++Arg)
+	{
+		const std::string Spec = Argv[Arg];
+		const std::size_t Separator = Spec.find('=');
+		if (Separator == std::string::npos || Separator == 0)
+		{
+			return Usage();
+		}
+
+		FClip Clip;
+		Clip.Id = static_cast<std::uint32_t>(std::strtoul(Spec.substr(0, Separator).c_str(), nullptr, 10));
+		Clip.Path = Spec.substr(Separator + 1);
+
+		std::vector<float> Stereo;
+		std::uint32_t WavRate = 0;
+		if (!LoadWav(Clip.Path, Stereo, WavRate))
+		{
+			std::fprintf(stderr, "Unsupported or unreadable WAV: %s\n", Clip.Path.c_str());
+			return 1;
+		}
+		Clip.Pcm = Resample(Stereo, WavRate, SampleRate);
+		Clip.Packets = EncodeBluetooth(Clip.Pcm, SampleRate);
+		Clips.push_back(std::move(Clip));
+	}
+
+	std::sort(Clips.begin(), Clips.end(), [](const FClip& A, const FClip& B) { return A.Id < B.Id; });
+	for (std::size_t Index = 1; Index < Clips.size(); ++Index)
+	{
+		if (Clips[Index - 1].Id == Clips[Index].Id)
+		{
+			std::fprintf(stderr, "Duplicate clip id: %u\n", Clips[Index].Id);
+			return 1;
+		}
+	}
+
+	FHapticBankHeader Header;
+	Header.SampleRate = SampleRate;
+	Header.ClipCount = static_cast<std::uint32_t>(Clips.size());
+	Header.IndexOffset = AlignUp(sizeof(FHapticBankHeader));
+
+	std::vector<std::uint8_t> Bank;
+	std::vector<FHapticBankEntry> Entries(Clips.size());
+	std::uint64_t Offset = AlignUp(Header.IndexOffset + (Entries.size() * sizeof(FHapticBankEntry)));
+	for (std::size_t Index = 0; Index < Clips.size(); ++Index)
+	{
+		const FClip& Clip = Clips[Index];
+		FHapticBankEntry& Entry = Entries[Index];
+		Entry.Id = Clip.Id;
+		Entry.Frames = static_cast<std::uint32_t>(Clip.Pcm.size() / 2);
+		Entry.PacketCount = static_cast<std::uint32_t>(Clip.Packets.size() / PacketSize);
+
+		Entry.PcmOffset = Offset;
+		WriteAt(Bank, Offset, Clip.Pcm.data(), Clip.Pcm.size() * sizeof(float));
+		Offset = AlignUp(Offset + (Clip.Pcm.size() * sizeof(float)));
+
+		Entry.PacketOffset = Offset;
+		WriteAt(Bank, Offset, Clip.Packets.data(), Clip.Packets.size());
+		Offset = AlignUp(Offset + Clip.Packets.size());
+
+		std::printf("clip %u: %u frames, %u packets (%s)\n", Entry.Id, Entry.Frames, Entry.PacketCount, Clip.Path.c_str());
+	}
+	WriteAt(Bank, 0, &Header, sizeof(Header));
+	if (!Entries.empty())
+	{
+		WriteAt(Bank, Header.IndexOffset, Entries.data(), Entries.size() * sizeof(FHapticBankEntry));
+	}
+
+	std::ofstream Output(OutputPath, std::ios::binary | std::ios::trunc);
+	Output.write(reinterpret_cast<const char*>(Bank.data()), static_cast<std::streamsize>(Bank.size()));
+	if (!Output)
+	{
+		std::fprintf(stderr, "Cannot write %s\n", OutputPath);
+		return 1;
+	}
+	return 0;
+}